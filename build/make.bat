@@ -1,5 +1,9 @@
 @echo off
 mkdir obj\
 del /S /Q obj\*
-g++ -O3 -std=c++14 -Wall -pedantic -c ..\src\main.cpp -o obj\main.o
-g++ -s -o ..\bin\obj2bom.exe obj\main.o
\ No newline at end of file
+g++ -O3 -std=c++14 -Wall -pedantic -pthread -c ..\src\main.cpp -o obj\main.o
+g++ -s -pthread -o ..\bin\obj2bom.exe obj\main.o
+
+if not "%1"=="test" goto :eof
+g++ -O3 -std=c++14 -Wall -pedantic -o obj\roundtrip.exe ..\tests\roundtrip.cpp
+obj\roundtrip.exe ..\bin\obj2bom.exe ..\tests\fixtures obj
\ No newline at end of file
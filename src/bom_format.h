@@ -0,0 +1,188 @@
+#ifndef BOM_FORMAT_H
+#define BOM_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+template <typename T>
+auto BitmaskFlag(T flag)
+{
+	return static_cast<typename std::underlying_type<T>::type>(flag);
+
+}
+
+// Version 2 stores counts, string lengths, string indices and material IDs as variable-length integers (unsigned LEB128) rather than the
+// fixed 16 and 32-bit fields of version 1, so that files are no longer limited to 65,535 materials, assets, objects or groups.
+static const std::uint8_t BOM_DATA_VERSION = 2;
+static const std::uint8_t BOM_LEGACY_DATA_VERSION = 1;
+static const std::size_t BOM_VARINT_MAX_SIZE = 10;
+
+// Material and map data attributes known to version 1 readers, which cannot skip the attributes that follow them.  Version 1 files are
+// written without the PBR properties and maps, and without the map options after the light map intensity.
+static const std::uint32_t BOM_LEGACY_MATERIAL_ATTRIBUTES = (1u << 19) - 1; // Up to LIGHT_MAP
+static const std::uint16_t BOM_LEGACY_MAP_ATTRIBUTES = (1u << 7) - 1; // Up to LIGHTMAP_INTENSITY
+
+// Vendor-specific Material Property
+enum class FaceCulling : std::uint8_t
+{
+	NONE = 0,
+	FRONT = 1,
+	BACK = 2,
+	ALL = 3,
+
+};
+
+// BOM
+enum class FileDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	MATERIAL_LIBRARY = 1 << 1,
+	BVH = 1 << 2,
+	STRING_TABLE = 1 << 3,
+	CONTENT_HASH = 1 << 4
+
+};
+
+// Sections listed in the content hash trailer, in file order.
+enum class BomSection : std::uint32_t
+{
+	HEADER = 0,
+	STRING_TABLE = 1,
+	MATERIAL_LIBRARY = 2,
+	ASSETS = 3,
+	BVH = 4
+
+};
+
+// The content hash trailer ends with its size in bytes followed by this signature, so that it can be found from the end of the file.
+static const char BOM_CONTENT_HASH_SIGNATURE[] = "BOMH";
+static const std::size_t BOM_CONTENT_HASH_SIGNATURE_SIZE = 4;
+
+enum class AssetDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	NAME = 1 << 1
+
+};
+
+enum class GroupDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	NAME = 1 << 1,
+	INDEX = 1 << 2,
+	SMOOTHING = 1 << 3,
+	MATERIAL = 1 << 4,
+	BOUNDS = 1 << 5
+
+};
+
+enum class ObjectDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	GEOMETRY = 1 << 1,
+	BOUNDS = 1 << 2
+
+};
+
+enum class GeometryDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	NORMAL = 1 << 1,
+	UV = 1 << 2,
+	UV2 = 1 << 3,
+	TANGENT = 1 << 4
+
+};
+
+enum class MaterialDataAttribute : std::uint32_t
+{
+	NONE = 1 << 0,
+	ILLUMINATION_MODEL = 1 << 1,
+	SPECULAR_EXPONENT = 1 << 2,
+	OPTICAL_DENSITY = 1 << 3,
+	DISSOLVE = 1 << 4,
+	TRANSMISSION_FILTER = 1 << 5,
+	AMBIENT_REFLECTANCE = 1 << 6,
+	DIFFUSE_REFLECTANCE = 1 << 7,
+	SPECULAR_REFLECTANCE = 1 << 8,
+	EMISSIVE_REFLECTANCE = 1 << 9,
+	AMBIENT_MAP = 1 << 10,
+	DIFFUSE_MAP = 1 << 11,
+	SPECULAR_MAP = 1 << 12,
+	EMISSIVE_MAP = 1 << 13,
+	DISSOLVE_MAP = 1 << 14,
+	BUMP_MAP = 1 << 15,
+	DISPLACEMENT_MAP = 1 << 16,
+	FACE_CULLING = 1 << 17,
+	LIGHT_MAP = 1 << 18,
+	ROUGHNESS = 1 << 19,
+	METALLIC = 1 << 20,
+	SHEEN = 1 << 21,
+	CLEARCOAT_THICKNESS = 1 << 22,
+	CLEARCOAT_ROUGHNESS = 1 << 23,
+	ANISOTROPY = 1 << 24,
+	ANISOTROPY_ROTATION = 1 << 25,
+	ROUGHNESS_MAP = 1 << 26,
+	METALLIC_MAP = 1 << 27,
+	SHEEN_MAP = 1 << 28,
+	NORMAL_MAP = 1 << 29
+
+};
+
+enum class MapDataAttribute : std::uint16_t
+{
+	NONE = 1 << 0,
+	PATH = 1 << 1,
+	SCALE = 1 << 2,
+	OFFSET = 1 << 3,
+	BUMP_SCALE = 1 << 4,
+	DISPLACEMENT_SCALE = 1 << 5,
+	LIGHTMAP_INTENSITY = 1 << 6,
+	OPTIONS = 1 << 7,
+	BOOST = 1 << 8,
+	RANGE = 1 << 9,
+	TURBULENCE = 1 << 10,
+	RESOLUTION = 1 << 11,
+	CHANNEL = 1 << 12,
+	PROJECTION = 1 << 13
+
+};
+
+// Map Options (-blendu, -blendv, -clamp, -cc)
+enum class MapOption : std::uint8_t
+{
+	NONE = 0,
+	BLEND_U = 1 << 0,
+	BLEND_V = 1 << 1,
+	CLAMP = 1 << 2,
+	COLOR_CORRECTION = 1 << 3,
+
+};
+
+// Map Channel (-imfchan)
+enum class MapChannel : std::uint8_t
+{
+	RED = 0,
+	GREEN = 1,
+	BLUE = 2,
+	MATTE = 3,
+	LUMINANCE = 4,
+	DEPTH = 5,
+
+};
+
+// Map Projection (-type)
+enum class MapProjection : std::uint8_t
+{
+	SPHERE = 0,
+	CUBE_TOP = 1,
+	CUBE_BOTTOM = 2,
+	CUBE_FRONT = 3,
+	CUBE_BACK = 4,
+	CUBE_LEFT = 5,
+	CUBE_RIGHT = 6,
+
+};
+
+#endif
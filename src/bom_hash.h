@@ -0,0 +1,135 @@
+#ifndef BOM_HASH_H
+#define BOM_HASH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// xxHash (XXH64)
+struct xxh64_t
+{
+	static const std::uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL, PRIME64_2 = 0xC2B2AE3D27D4EB4FULL, PRIME64_3 = 0x165667B19E3779F9ULL, PRIME64_4 = 0x85EBCA77C2B2AE63ULL, PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+	static std::uint64_t Rotl(std::uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+	static std::uint64_t Read64(const unsigned char *p) { std::uint64_t value; std::memcpy(&value, p, sizeof(value)); return value; }
+	static std::uint32_t Read32(const unsigned char *p) { std::uint32_t value; std::memcpy(&value, p, sizeof(value)); return value; }
+	static std::uint64_t Round(std::uint64_t acc, std::uint64_t input) { return Rotl(acc + input * PRIME64_2, 31) * PRIME64_1; }
+	static std::uint64_t MergeRound(std::uint64_t acc, std::uint64_t value) { return (acc ^ Round(0, value)) * PRIME64_1 + PRIME64_4; }
+
+	// Consumes one 32-byte stripe in to the four accumulators.
+	static void Stripe(std::uint64_t (&v)[4], const unsigned char *p)
+	{
+		v[0] = Round(v[0], Read64(p));
+		v[1] = Round(v[1], Read64(p + 8));
+		v[2] = Round(v[2], Read64(p + 16));
+		v[3] = Round(v[3], Read64(p + 24));
+
+	}
+
+	static std::uint64_t Merge(const std::uint64_t (&v)[4])
+	{
+		std::uint64_t hash = Rotl(v[0], 1) + Rotl(v[1], 7) + Rotl(v[2], 12) + Rotl(v[3], 18);
+		for(auto value : v) hash = MergeRound(hash, value);
+		return hash;
+
+	}
+
+	// Consumes the final bytes, fewer than 32, and avalanches the hash.
+	static std::uint64_t Finalize(std::uint64_t hash, const unsigned char *p, const unsigned char *end)
+	{
+		for(; p + 8 <= end; p += 8) hash = Rotl(hash ^ Round(0, Read64(p)), 27) * PRIME64_1 + PRIME64_4;
+		if(p + 4 <= end)
+		{
+			hash = Rotl(hash ^ (Read32(p) * PRIME64_1), 23) * PRIME64_2 + PRIME64_3;
+			p += 4;
+
+		}
+
+		for(; p < end; ++p) hash = Rotl(hash ^ (*p * PRIME64_5), 11) * PRIME64_1;
+
+		hash ^= hash >> 33;
+		hash *= PRIME64_2;
+		hash ^= hash >> 29;
+		hash *= PRIME64_3;
+		hash ^= hash >> 32;
+		return hash;
+
+	}
+
+};
+
+inline std::uint64_t HashXXH64(const void *data, std::size_t size, std::uint64_t seed = 0)
+{
+	const auto *p = static_cast<const unsigned char*>(data);
+	const auto *end = p + size;
+	std::uint64_t hash;
+
+	if(size >= 32)
+	{
+		std::uint64_t v[4] = { seed + xxh64_t::PRIME64_1 + xxh64_t::PRIME64_2, seed + xxh64_t::PRIME64_2, seed, seed - xxh64_t::PRIME64_1 };
+		for(; p + 32 <= end; p += 32) xxh64_t::Stripe(v, p);
+		hash = xxh64_t::Merge(v);
+
+	}
+	else
+	{
+		hash = seed + xxh64_t::PRIME64_5;
+
+	}
+
+	return xxh64_t::Finalize(hash + size, p, end);
+
+}
+
+// Streaming XXH64
+// Hashes data supplied in pieces, giving the same digest as HashXXH64 over their concatenation.
+class HashXXH64Stream
+{
+public:
+	explicit HashXXH64Stream(std::uint64_t seed = 0) : seed(seed), v { seed + xxh64_t::PRIME64_1 + xxh64_t::PRIME64_2, seed + xxh64_t::PRIME64_2, seed, seed - xxh64_t::PRIME64_1 } {}
+
+	void Update(const void *data, std::size_t count)
+	{
+		const auto *p = static_cast<const unsigned char*>(data);
+		const auto *end = p + count;
+		size += count;
+
+		if(buffered > 0)
+		{
+			const std::size_t fill = std::min<std::size_t>(32 - buffered, count);
+			std::memcpy(buffer + buffered, p, fill);
+			buffered += fill;
+			p += fill;
+			if(buffered < 32) return;
+
+			xxh64_t::Stripe(v, buffer);
+			buffered = 0;
+
+		}
+
+		for(; p + 32 <= end; p += 32) xxh64_t::Stripe(v, p);
+
+		buffered = static_cast<std::size_t>(end - p);
+		std::memcpy(buffer, p, buffered);
+
+	}
+
+	std::uint64_t Digest() const
+	{
+		const std::uint64_t hash = size >= 32 ? xxh64_t::Merge(v) : seed + xxh64_t::PRIME64_5;
+		return xxh64_t::Finalize(hash + size, buffer, buffer + buffered);
+
+	}
+
+	// Number of bytes hashed so far
+	std::uint64_t Size() const { return size; }
+
+private:
+	std::uint64_t seed, v[4], size = 0;
+	unsigned char buffer[32];
+	std::size_t buffered = 0;
+
+};
+
+#endif
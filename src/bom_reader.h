@@ -0,0 +1,667 @@
+#ifndef BOM_READER_H
+#define BOM_READER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include "bom_format.h"
+#include "bom_hash.h"
+
+// BOM Reader
+// Parses a BOM file held in memory (loaded or memory mapped) into views over the original buffer without copying geometry or string data.
+// The buffer must outlive the reader and any views obtained from it.
+class BomReader
+{
+public:
+	// Read-only view over a typed array stored in the buffer, elements are copied out on access as BOM data carries no alignment guarantees.
+	template <typename T>
+	struct span_t
+	{
+		const char *data = nullptr;
+		std::size_t size = 0;
+
+		T operator[](std::size_t i) const
+		{
+			T value;
+			std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+			return value;
+
+		}
+
+		std::size_t bytes() const { return size * sizeof(T); }
+		bool empty() const { return size == 0; }
+
+	};
+
+	// Read-only view over a length-prefixed string stored in the buffer.  With a string table, fields referencing the same string share one view.
+	struct string_t
+	{
+		const char *data = nullptr;
+		std::size_t size = 0;
+
+		std::string str() const { return std::string(data, size); }
+		bool operator==(const std::string &other) const { return size == other.size() && std::memcmp(data, other.data(), size) == 0; }
+		bool operator!=(const std::string &other) const { return !(*this == other); }
+
+	};
+
+	struct vector2_t
+	{
+		float x, y;
+
+	};
+
+	struct vector3_t
+	{
+		float x, y, z;
+
+	};
+
+	// Axis-aligned bounding box and bounding sphere
+	struct bounds_t
+	{
+		vector3_t min, max, center;
+		float radius;
+
+	};
+
+	struct color_t
+	{
+		float r, g, b;
+
+	};
+
+	struct map_t
+	{
+		decltype(BitmaskFlag(MapDataAttribute::NONE)) attributes = 0;
+		string_t path;
+		vector2_t scale = { 1.0f, 1.0f }, offset = { 0.0f, 0.0f };
+		float bumpScale = 1.0f, displacementScale = 1.0f, lightmapIntensity = 1.0f;
+		decltype(BitmaskFlag(MapOption::NONE)) options = BitmaskFlag(MapOption::BLEND_U) | BitmaskFlag(MapOption::BLEND_V);
+		float boost = 0.0f;
+		vector2_t range = { 0.0f, 1.0f }; // Base and gain
+		vector3_t turbulence = { 0.0f, 0.0f, 0.0f };
+		std::uint32_t resolution = 0;
+		MapChannel channel = MapChannel::LUMINANCE;
+		MapProjection projection = MapProjection::SPHERE;
+
+	};
+
+	struct material_t
+	{
+		decltype(BitmaskFlag(MaterialDataAttribute::NONE)) attributes = 0;
+		string_t name;
+		std::uint8_t illuminationModel = 0;
+		float specularExponent = 0.0f, opticalDensity = 1.0f, dissolve = 1.0f;
+		color_t transmissionFilter {}, ambientReflectance {}, diffuseReflectance {}, specularReflectance {}, emissiveReflectance {};
+		map_t ambientMap, diffuseMap, specularMap, emissiveMap, dissolveMap, bumpMap, displacementMap, lightMap;
+		FaceCulling faceCulling = FaceCulling::BACK;
+		float roughness = 0.0f, metallic = 0.0f, sheen = 0.0f, clearcoatThickness = 0.0f, clearcoatRoughness = 0.0f, anisotropy = 0.0f, anisotropyRotation = 0.0f;
+		map_t roughnessMap, metallicMap, sheenMap, normalMap;
+
+	};
+
+	struct group_t
+	{
+		decltype(BitmaskFlag(GroupDataAttribute::NONE)) attributes = 0;
+		string_t name;
+		span_t<std::uint16_t> indices;
+		std::uint8_t smoothing = 0;
+		std::uint32_t materialId = 0;
+		bounds_t bounds {};
+
+	};
+
+	struct object_t
+	{
+		decltype(BitmaskFlag(ObjectDataAttribute::NONE)) attributes = 0;
+		decltype(BitmaskFlag(GeometryDataAttribute::NONE)) geometryAttributes = 0;
+		std::uint32_t vertexCount = 0;
+		span_t<float> positions, normals, uvs, uvs2, tangents;
+		bounds_t bounds {};
+		std::vector<group_t> groups;
+
+	};
+
+	// Scene BVH node, stored depth-first so that the first child of an interior node immediately follows it.
+	struct bvh_node_t
+	{
+		vector3_t min, max;
+		std::uint32_t offset; // Leaf: Index of the first primitive, Interior: Index of the second child
+		std::uint16_t primitiveCount; // Zero for interior nodes
+		std::uint8_t axis, padding;
+
+	};
+
+	// Scene BVH primitive, referencing a triangle range of a group where objects are numbered in file order across all assets.
+	// A group index of 0xFFFFFFFF references all non-indexed geometry of the object.
+	struct bvh_primitive_t
+	{
+		std::uint32_t objectIndex, groupIndex, firstTriangle, triangleCount;
+
+	};
+
+	// Content hash trailer entry, covering the bytes of one section of the file.
+	struct section_t
+	{
+		BomSection type;
+		std::uint64_t offset, size, contentHash;
+
+	};
+
+	struct asset_t
+	{
+		decltype(BitmaskFlag(AssetDataAttribute::NONE)) attributes = 0;
+		string_t name;
+		std::vector<object_t> objects;
+
+	};
+
+	std::uint8_t version = 0;
+	decltype(BitmaskFlag(FileDataAttribute::NONE)) attributes = 0;
+	std::vector<string_t> strings;
+	std::vector<material_t> materials;
+	std::vector<asset_t> assets;
+	span_t<bvh_primitive_t> bvhPrimitives;
+	span_t<bvh_node_t> bvhNodes;
+	std::vector<section_t> sections;
+	std::uint64_t contentHash = 0;
+
+	// Loads a BOM file in to a buffer owned by the reader and parses it.
+	bool Load(const std::string &bomFilePath)
+	{
+		std::ifstream bomFile(bomFilePath, std::ios::in | std::ios::binary);
+		if(!bomFile.is_open()) return Fail("Failed to open BOM file '" + bomFilePath + "'");
+
+		buffer.assign(std::istreambuf_iterator<char>(bomFile), std::istreambuf_iterator<char>());
+		bomFile.close();
+
+		return Parse(buffer.data(), buffer.size());
+
+	}
+
+	// Parses a BOM file from an externally owned buffer.
+	bool Parse(const void *data, std::size_t size)
+	{
+		begin = cursor = static_cast<const char*>(data);
+		end = begin + size;
+		error.clear();
+		version = 0;
+		attributes = 0;
+		strings.clear();
+		materials.clear();
+		assets.clear();
+		bvhPrimitives = span_t<bvh_primitive_t>();
+		bvhNodes = span_t<bvh_node_t>();
+		sections.clear();
+		contentHash = 0;
+
+		// File Signature
+		if(!Require(3) || std::memcmp(cursor, "BOM", 3) != 0) return Fail("Invalid file signature");
+		cursor += 3;
+
+		// Version
+		if(!Read(version)) return false;
+		if(version != BOM_DATA_VERSION && version != BOM_LEGACY_DATA_VERSION) return Fail("Unsupported version " + std::to_string(version));
+
+		// File Data Attributes
+		if(!Read(attributes)) return false;
+
+		if(attributes & BitmaskFlag(FileDataAttribute::STRING_TABLE))
+		{
+			// String Count
+			std::size_t stringCount;
+			if(!ReadElementCount<std::uint32_t>(stringCount)) return false;
+			strings.resize(stringCount);
+
+			for(auto &string : strings)
+			{
+				if(!ReadInlineString(string)) return false;
+
+			}
+
+		}
+
+		if(attributes & BitmaskFlag(FileDataAttribute::MATERIAL_LIBRARY))
+		{
+			// Material Count
+			std::size_t materialCount;
+			if(!ReadElementCount<std::uint16_t>(materialCount)) return false;
+			materials.resize(materialCount);
+
+			for(auto &material : materials)
+			{
+				if(!ReadMaterial(material)) return false;
+
+			}
+
+		}
+
+		// Asset Count
+		std::size_t assetCount;
+		if(!ReadElementCount<std::uint16_t>(assetCount)) return false;
+		assets.resize(assetCount);
+
+		for(auto &asset : assets)
+		{
+			if(!ReadAsset(asset)) return false;
+
+		}
+
+		if((attributes & BitmaskFlag(FileDataAttribute::BVH)) && !ReadBVH()) return false;
+
+		if((attributes & BitmaskFlag(FileDataAttribute::CONTENT_HASH)) && !ReadContentHash()) return false;
+
+		if(cursor != end) return Fail("Unexpected trailing data");
+		return true;
+
+	}
+
+	const std::string &GetError() const { return error; }
+
+	// Checks the whole file hash of a BOM file carrying a content hash trailer without parsing it, optionally returning the hash.
+	static bool CheckContentHash(const void *data, std::size_t size, std::uint64_t *fileHash = nullptr)
+	{
+		const auto *bytes = static_cast<const char*>(data);
+		const std::size_t footerSize = sizeof(std::uint32_t) + BOM_CONTENT_HASH_SIGNATURE_SIZE;
+		if(size < footerSize + sizeof(std::uint64_t) || std::memcmp(bytes + size - BOM_CONTENT_HASH_SIGNATURE_SIZE, BOM_CONTENT_HASH_SIGNATURE, BOM_CONTENT_HASH_SIGNATURE_SIZE) != 0) return false;
+
+		std::uint32_t trailerSize;
+		std::memcpy(&trailerSize, bytes + size - footerSize, sizeof(trailerSize));
+		if(trailerSize > size || trailerSize < footerSize + sizeof(std::uint64_t)) return false;
+
+		std::uint64_t storedHash;
+		const std::size_t hashedSize = size - footerSize - sizeof(storedHash);
+		std::memcpy(&storedHash, bytes + hashedSize, sizeof(storedHash));
+		if(HashXXH64(bytes, hashedSize) != storedHash) return false;
+
+		if(fileHash) *fileHash = storedHash;
+		return true;
+
+	}
+
+private:
+	std::vector<char> buffer;
+	const char *begin = nullptr, *cursor = nullptr, *end = nullptr;
+	std::string error;
+
+	bool Fail(const std::string &message)
+	{
+		error = message;
+		if(begin && cursor) error += " at offset " + std::to_string(cursor - begin);
+		return false;
+
+	}
+
+	bool Require(std::size_t size)
+	{
+		if(static_cast<std::size_t>(end - cursor) < size) return Fail("Unexpected end of file");
+		return true;
+
+	}
+
+	template <typename T>
+	bool Read(T &value)
+	{
+		if(!Require(sizeof(T))) return false;
+		std::memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return true;
+
+	}
+
+	// Reads a count, length or index, stored as a fixed-size integer of type T in version 1 files and as a variable-length integer since.
+	template <typename T, typename V>
+	bool ReadCount(V &value)
+	{
+		if(version == BOM_LEGACY_DATA_VERSION)
+		{
+			T fixedValue;
+			if(!Read(fixedValue)) return false;
+			value = fixedValue;
+			return true;
+
+		}
+
+		std::uint64_t varint = 0;
+		for(unsigned int shift = 0;; shift += 7)
+		{
+			if(!Require(1)) return false;
+			const auto byte = static_cast<std::uint8_t>(*cursor++);
+			if(shift == 63 && byte > 1) return Fail("Variable-length integer overflow");
+
+			varint |= std::uint64_t(byte & 0x7F) << shift;
+			if(!(byte & 0x80)) break;
+
+		}
+
+		if(varint > std::numeric_limits<V>::max()) return Fail("Variable-length integer out of range");
+		value = static_cast<V>(varint);
+		return true;
+
+	}
+
+	// Reads the element count of an array, which cannot exceed the remaining size of the file as every element takes at least one byte.
+	template <typename T>
+	bool ReadElementCount(std::size_t &count)
+	{
+		if(!ReadCount<T>(count)) return false;
+		if(count > static_cast<std::size_t>(end - cursor)) return Fail("Unexpected end of file");
+		return true;
+
+	}
+
+	template <typename T>
+	bool ReadSpan(span_t<T> &span, std::size_t count)
+	{
+		if(count > static_cast<std::size_t>(end - cursor) / sizeof(T)) return Fail("Unexpected end of file");
+		span.data = cursor;
+		span.size = count;
+		cursor += count * sizeof(T);
+		return true;
+
+	}
+
+	// Reads a string field, either stored inline or as an index in to the string table.
+	bool ReadString(string_t &string)
+	{
+		if(!(attributes & BitmaskFlag(FileDataAttribute::STRING_TABLE))) return ReadInlineString(string);
+
+		std::size_t stringIndex;
+		if(!ReadCount<std::uint32_t>(stringIndex)) return false;
+		if(stringIndex >= strings.size()) return Fail("String index out of range");
+		string = strings[stringIndex];
+		return true;
+
+	}
+
+	bool ReadInlineString(string_t &string)
+	{
+		std::size_t length = 0;
+		if(!ReadCount<std::uint16_t>(length) || !Require(length)) return false;
+		string.data = cursor;
+		string.size = length;
+		cursor += length;
+		return true;
+
+	}
+
+	bool ReadMap(map_t &map)
+	{
+		// Map Data Attributes
+		if(!Read(map.attributes)) return false;
+
+		// Map Path
+		if((map.attributes & BitmaskFlag(MapDataAttribute::PATH)) && !ReadString(map.path)) return false;
+
+		// Map Scale
+		if((map.attributes & BitmaskFlag(MapDataAttribute::SCALE)) && !Read(map.scale)) return false;
+
+		// Map Offset
+		if((map.attributes & BitmaskFlag(MapDataAttribute::OFFSET)) && !Read(map.offset)) return false;
+
+		// Map Bump Scale
+		if((map.attributes & BitmaskFlag(MapDataAttribute::BUMP_SCALE)) && !Read(map.bumpScale)) return false;
+
+		// Map Displacement Scale
+		if((map.attributes & BitmaskFlag(MapDataAttribute::DISPLACEMENT_SCALE)) && !Read(map.displacementScale)) return false;
+
+		// Light Map Intensity
+		if((map.attributes & BitmaskFlag(MapDataAttribute::LIGHTMAP_INTENSITY)) && !Read(map.lightmapIntensity)) return false;
+
+		// Map Options, Boost, Range, Turbulence & Resolution
+		if((map.attributes & BitmaskFlag(MapDataAttribute::OPTIONS)) && !Read(map.options)) return false;
+		if((map.attributes & BitmaskFlag(MapDataAttribute::BOOST)) && !Read(map.boost)) return false;
+		if((map.attributes & BitmaskFlag(MapDataAttribute::RANGE)) && !Read(map.range)) return false;
+		if((map.attributes & BitmaskFlag(MapDataAttribute::TURBULENCE)) && !Read(map.turbulence)) return false;
+		if((map.attributes & BitmaskFlag(MapDataAttribute::RESOLUTION)) && !Read(map.resolution)) return false;
+
+		// Map Channel
+		if((map.attributes & BitmaskFlag(MapDataAttribute::CHANNEL)) && !Read(map.channel)) return false;
+		if(map.channel > MapChannel::DEPTH) return Fail("Invalid map channel");
+
+		// Map Projection
+		if((map.attributes & BitmaskFlag(MapDataAttribute::PROJECTION)) && !Read(map.projection)) return false;
+		if(map.projection > MapProjection::CUBE_RIGHT) return Fail("Invalid map projection");
+
+		return true;
+
+	}
+
+	bool ReadMaterial(material_t &material)
+	{
+		// Material Data Attributes
+		if(!Read(material.attributes)) return false;
+
+		// Material Name
+		if(!ReadString(material.name)) return false;
+
+		auto has = [&material](MaterialDataAttribute attribute) { return (material.attributes & BitmaskFlag(attribute)) != 0; };
+
+		if(has(MaterialDataAttribute::ILLUMINATION_MODEL) && !Read(material.illuminationModel)) return false;
+		if(has(MaterialDataAttribute::SPECULAR_EXPONENT) && !Read(material.specularExponent)) return false;
+		if(has(MaterialDataAttribute::OPTICAL_DENSITY) && !Read(material.opticalDensity)) return false;
+		if(has(MaterialDataAttribute::DISSOLVE) && !Read(material.dissolve)) return false;
+		if(has(MaterialDataAttribute::TRANSMISSION_FILTER) && !Read(material.transmissionFilter)) return false;
+		if(has(MaterialDataAttribute::AMBIENT_REFLECTANCE) && !Read(material.ambientReflectance)) return false;
+		if(has(MaterialDataAttribute::DIFFUSE_REFLECTANCE) && !Read(material.diffuseReflectance)) return false;
+		if(has(MaterialDataAttribute::SPECULAR_REFLECTANCE) && !Read(material.specularReflectance)) return false;
+		if(has(MaterialDataAttribute::EMISSIVE_REFLECTANCE) && !Read(material.emissiveReflectance)) return false;
+		if(has(MaterialDataAttribute::AMBIENT_MAP) && !ReadMap(material.ambientMap)) return false;
+		if(has(MaterialDataAttribute::DIFFUSE_MAP) && !ReadMap(material.diffuseMap)) return false;
+		if(has(MaterialDataAttribute::SPECULAR_MAP) && !ReadMap(material.specularMap)) return false;
+		if(has(MaterialDataAttribute::EMISSIVE_MAP) && !ReadMap(material.emissiveMap)) return false;
+		if(has(MaterialDataAttribute::DISSOLVE_MAP) && !ReadMap(material.dissolveMap)) return false;
+		if(has(MaterialDataAttribute::BUMP_MAP) && !ReadMap(material.bumpMap)) return false;
+		if(has(MaterialDataAttribute::DISPLACEMENT_MAP) && !ReadMap(material.displacementMap)) return false;
+		if(has(MaterialDataAttribute::FACE_CULLING) && !Read(material.faceCulling)) return false;
+		if(has(MaterialDataAttribute::LIGHT_MAP) && !ReadMap(material.lightMap)) return false;
+		if(has(MaterialDataAttribute::ROUGHNESS) && !Read(material.roughness)) return false;
+		if(has(MaterialDataAttribute::METALLIC) && !Read(material.metallic)) return false;
+		if(has(MaterialDataAttribute::SHEEN) && !Read(material.sheen)) return false;
+		if(has(MaterialDataAttribute::CLEARCOAT_THICKNESS) && !Read(material.clearcoatThickness)) return false;
+		if(has(MaterialDataAttribute::CLEARCOAT_ROUGHNESS) && !Read(material.clearcoatRoughness)) return false;
+		if(has(MaterialDataAttribute::ANISOTROPY) && !Read(material.anisotropy)) return false;
+		if(has(MaterialDataAttribute::ANISOTROPY_ROTATION) && !Read(material.anisotropyRotation)) return false;
+		if(has(MaterialDataAttribute::ROUGHNESS_MAP) && !ReadMap(material.roughnessMap)) return false;
+		if(has(MaterialDataAttribute::METALLIC_MAP) && !ReadMap(material.metallicMap)) return false;
+		if(has(MaterialDataAttribute::SHEEN_MAP) && !ReadMap(material.sheenMap)) return false;
+		if(has(MaterialDataAttribute::NORMAL_MAP) && !ReadMap(material.normalMap)) return false;
+
+		if(material.faceCulling > FaceCulling::ALL) return Fail("Invalid face culling mode");
+		return true;
+
+	}
+
+	bool ReadBVH()
+	{
+		std::vector<const object_t*> objects;
+		for(const auto &asset : assets) for(const auto &object : asset.objects) objects.push_back(&object);
+
+		// BVH Primitives
+		std::size_t primitiveCount;
+		if(!ReadCount<std::uint32_t>(primitiveCount) || !ReadSpan(bvhPrimitives, primitiveCount)) return false;
+
+		// Every primitive must reference triangles that exist, so that traversal can index the object, group and indices it names directly.
+		for(std::size_t i = 0; i < bvhPrimitives.size; ++i)
+		{
+			const auto primitive = bvhPrimitives[i];
+			if(primitive.objectIndex >= objects.size()) return Fail("BVH primitive object index out of range");
+
+			const auto &object = *objects[primitive.objectIndex];
+			std::size_t triangleCount;
+			if(primitive.groupIndex == std::numeric_limits<std::uint32_t>::max()) triangleCount = object.vertexCount / 3;
+			else if(primitive.groupIndex < object.groups.size()) triangleCount = object.groups[primitive.groupIndex].indices.size / 3;
+			else return Fail("BVH primitive group index out of range");
+
+			if(primitive.firstTriangle > triangleCount || primitive.triangleCount > triangleCount - primitive.firstTriangle) return Fail("BVH primitive triangle range out of range");
+
+		}
+
+		// BVH Nodes
+		std::size_t nodeCount;
+		if(!ReadCount<std::uint32_t>(nodeCount) || !ReadSpan(bvhNodes, nodeCount)) return false;
+
+		for(std::size_t i = 0; i < bvhNodes.size; ++i)
+		{
+			const auto node = bvhNodes[i];
+			if(node.primitiveCount > 0 && std::size_t(node.offset) + node.primitiveCount > bvhPrimitives.size) return Fail("BVH leaf primitive range out of range");
+			if(node.primitiveCount == 0 && (node.offset <= i + 1 || node.offset >= bvhNodes.size)) return Fail("BVH child index out of range");
+
+		}
+
+		return true;
+
+	}
+
+	bool ReadContentHash()
+	{
+		const auto *trailer = cursor;
+
+		// Section Count
+		std::uint32_t sectionCount;
+		if(!Read(sectionCount)) return false;
+		if(sectionCount > static_cast<std::size_t>(end - cursor) / 28) return Fail("Unexpected end of file");
+		sections.resize(sectionCount);
+
+		for(auto &section : sections)
+		{
+			std::uint32_t sectionType;
+			if(!Read(sectionType) || !Read(section.offset) || !Read(section.size) || !Read(section.contentHash)) return false;
+			section.type = static_cast<BomSection>(sectionType);
+
+			if(section.offset > static_cast<std::size_t>(trailer - begin) || section.size > static_cast<std::size_t>(trailer - begin) - section.offset) return Fail("Section out of range");
+			if(HashXXH64(begin + section.offset, section.size) != section.contentHash) return Fail("Section content hash mismatch");
+
+		}
+
+		// File Hash
+		const auto hashedSize = static_cast<std::size_t>(cursor - begin);
+		if(!Read(contentHash)) return false;
+		if(HashXXH64(begin, hashedSize) != contentHash) return Fail("File content hash mismatch");
+
+		// Trailer Size & Signature
+		std::uint32_t trailerSize;
+		if(!Read(trailerSize) || !Require(BOM_CONTENT_HASH_SIGNATURE_SIZE)) return false;
+		if(std::memcmp(cursor, BOM_CONTENT_HASH_SIGNATURE, BOM_CONTENT_HASH_SIGNATURE_SIZE) != 0) return Fail("Invalid content hash signature");
+		cursor += BOM_CONTENT_HASH_SIGNATURE_SIZE;
+
+		if(trailerSize != static_cast<std::size_t>(cursor - trailer)) return Fail("Invalid content hash trailer size");
+		return true;
+
+	}
+
+	bool ReadAsset(asset_t &asset)
+	{
+		// Asset Data Attributes
+		if(!Read(asset.attributes)) return false;
+
+		// Asset Name
+		if((asset.attributes & BitmaskFlag(AssetDataAttribute::NAME)) && !ReadString(asset.name)) return false;
+
+		// Object Count
+		std::size_t objectCount;
+		if(!ReadElementCount<std::uint16_t>(objectCount)) return false;
+		asset.objects.resize(objectCount);
+
+		for(auto &object : asset.objects)
+		{
+			if(!ReadObject(object)) return false;
+
+		}
+
+		return true;
+
+	}
+
+	bool ReadObject(object_t &object)
+	{
+		// Object Data Attributes
+		if(!Read(object.attributes)) return false;
+
+		const bool hasGeometry = (object.attributes & BitmaskFlag(ObjectDataAttribute::GEOMETRY)) != 0;
+		if(hasGeometry)
+		{
+			// Geometry Data Attributes
+			if(!Read(object.geometryAttributes)) return false;
+
+			// Vertex Count
+			if(!ReadCount<std::uint32_t>(object.vertexCount)) return false;
+
+			// Vertex Positions
+			if(!ReadSpan(object.positions, std::size_t(object.vertexCount) * 3)) return false;
+
+			// Vertex Normals
+			if((object.geometryAttributes & BitmaskFlag(GeometryDataAttribute::NORMAL)) && !ReadSpan(object.normals, std::size_t(object.vertexCount) * 3)) return false;
+
+			// Vertex UVs
+			if((object.geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV)) && !ReadSpan(object.uvs, std::size_t(object.vertexCount) * 2)) return false;
+			if((object.geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV2)) && !ReadSpan(object.uvs2, std::size_t(object.vertexCount) * 2)) return false;
+
+			// Vertex Tangents
+			if((object.geometryAttributes & BitmaskFlag(GeometryDataAttribute::TANGENT)) && !ReadSpan(object.tangents, std::size_t(object.vertexCount) * 4)) return false;
+
+		}
+
+		// Object Bounds
+		if((object.attributes & BitmaskFlag(ObjectDataAttribute::BOUNDS)) && !Read(object.bounds)) return false;
+
+		// Group Count
+		std::size_t groupCount;
+		if(!ReadElementCount<std::uint16_t>(groupCount)) return false;
+		object.groups.resize(groupCount);
+
+		for(auto &group : object.groups)
+		{
+			// Group Data Attributes
+			if(!Read(group.attributes)) return false;
+
+			// Group Name
+			if((group.attributes & BitmaskFlag(GroupDataAttribute::NAME)) && !ReadString(group.name)) return false;
+
+			if(!hasGeometry) continue;
+
+			// Indices
+			if(group.attributes & BitmaskFlag(GroupDataAttribute::INDEX))
+			{
+				std::size_t indexCount;
+				if(!ReadCount<std::uint32_t>(indexCount)) return false;
+				if(indexCount % 3 != 0) return Fail("Index count is not a multiple of 3");
+				if(!ReadSpan(group.indices, indexCount)) return false;
+
+				for(std::size_t i = 0; i < group.indices.size; ++i)
+				{
+					if(group.indices[i] >= object.vertexCount) return Fail("Index out of range");
+
+				}
+
+			}
+
+			// Smoothing
+			if((group.attributes & BitmaskFlag(GroupDataAttribute::SMOOTHING)) && !Read(group.smoothing)) return false;
+
+			// Material ID
+			if(group.attributes & BitmaskFlag(GroupDataAttribute::MATERIAL))
+			{
+				if(!ReadCount<std::uint16_t>(group.materialId)) return false;
+				if(group.materialId >= materials.size()) return Fail("Material ID out of range");
+
+			}
+
+			// Group Bounds
+			if((group.attributes & BitmaskFlag(GroupDataAttribute::BOUNDS)) && !Read(group.bounds)) return false;
+
+		}
+
+		return true;
+
+	}
+
+};
+
+#endif
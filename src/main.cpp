@@ -8,121 +8,87 @@
 #include <map>
 #include <set>
 #include <type_traits>
-#include <regex>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <iomanip>
+#include <iterator>
+#include <unordered_map>
+#include <tuple>
+#include <limits>
+#include <cmath>
+#include <future>
+#include <cstring>
+#include <atomic>
+
+#include <csignal>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OBJ2BOM_SSE2 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define OBJ2BOM_AVX 1
+#endif
+#endif
+
+#include "bom_format.h"
+#include "bom_hash.h"
+#include "bom_reader.h"
+
+// Vertex indices are 32-bit while converting and narrowed to the 16-bit indices of the BOM format when written, once oversized objects
+// have been split in to chunks.
+typedef std::uint32_t obj_index_t;
+typedef std::uint16_t bom_index_t;
+const std::size_t maxIndexableVertices = std::size_t(std::numeric_limits<bom_index_t>::max()) + 1;
 
-template <typename T>
-auto BitmaskFlag(T flag)
-{
-	return static_cast<typename std::underlying_type<T>::type>(flag);
-
-}
-
-static const std::uint8_t BOM_DATA_VERSION = 1;
-
-typedef std::uint16_t obj_index_t;
-
-// Vendor-specific Material Property
-enum class FaceCulling : std::uint8_t
-{
-	NONE = 0,
-	FRONT = 1,
-	BACK = 2,
-	ALL = 3,
-
-};
-
-// BOM
-enum class FileDataAttribute : std::uint16_t
-{
-	NONE = 1 << 0,
-	MATERIAL_LIBRARY = 1 << 1
-
-};
-
-enum class AssetDataAttribute : std::uint16_t
-{
-	NONE = 1 << 0,
-	NAME = 1 << 1
-
-};
-
-enum class GroupDataAttribute : std::uint16_t
-{
-	NONE = 1 << 0,
-	NAME = 1 << 1,
-	INDEX = 1 << 2,
-	SMOOTHING = 1 << 3,
-	MATERIAL = 1 << 4
-
-};
-
-enum class ObjectDataAttribute : std::uint16_t
-{
-	NONE = 1 << 0,
-	GEOMETRY = 1 << 1
-
-};
-
-enum class GeometryDataAttribute : std::uint16_t
+struct alignas(1) obj_vector3_t
 {
-	NONE = 1 << 0,
-	NORMAL = 1 << 1,
-	UV = 1 << 2,
-	UV2 = 1 << 3
-
-};
-
-enum class MaterialDataAttribute : std::uint32_t
-{
-	NONE = 1 << 0,
-	ILLUMINATION_MODEL = 1 << 1,
-	SPECULAR_EXPONENT = 1 << 2,
-	OPTICAL_DENSITY = 1 << 3,
-	DISSOLVE = 1 << 4,
-	TRANSMISSION_FILTER = 1 << 5,
-	AMBIENT_REFLECTANCE = 1 << 6,
-	DIFFUSE_REFLECTANCE = 1 << 7,
-	SPECULAR_REFLECTANCE = 1 << 8,
-	EMISSIVE_REFLECTANCE = 1 << 9,
-	AMBIENT_MAP = 1 << 10,
-	DIFFUSE_MAP = 1 << 11,
-	SPECULAR_MAP = 1 << 12,
-	EMISSIVE_MAP = 1 << 13,
-	DISSOLVE_MAP = 1 << 14,
-	BUMP_MAP = 1 << 15,
-	DISPLACEMENT_MAP = 1 << 16,
-	FACE_CULLING = 1 << 17,
-	LIGHT_MAP = 1 << 18
+	float x, y, z;
 
 };
 
-enum class MapDataAttribute : std::uint16_t
+struct alignas(1) obj_vector2_t
 {
-	NONE = 1 << 0,
-	PATH = 1 << 1,
-	SCALE = 1 << 2,
-	OFFSET = 1 << 3,
-	BUMP_SCALE = 1 << 4,
-	DISPLACEMENT_SCALE = 1 << 5,
-	LIGHTMAP_INTENSITY = 1 << 6
+	float x, y;
 
 };
 
-struct alignas(1) obj_vector3_t
+struct alignas(1) obj_vector4_t
 {
-	float x, y, z;
+	float x, y, z, w;
 
 };
 
-struct alignas(1) obj_vector2_t
+struct alignas(1) obj_face3_t
 {
-	float x, y;
+	obj_index_t a, b, c;
 
 };
 
-struct alignas(1) obj_face3_t
+// Axis-aligned bounding box and bounding sphere
+struct alignas(1) obj_bounds_t
 {
-	obj_index_t a, b, c;
+	obj_vector3_t min, max, center;
+	float radius;
 
 };
 
@@ -144,13 +110,20 @@ struct mtl_map_t
 		float lightmapIntensity;
 
 	};
+	decltype(BitmaskFlag(MapOption::NONE)) options;
+	float boost;
+	obj_vector2_t range; // Base and gain
+	obj_vector3_t turbulence;
+	std::uint32_t resolution;
+	MapChannel channel;
+	MapProjection projection;
 
 };
 
 // MTL Properties
 struct mtl_material_t
 {
-	std::uint16_t id;
+	std::uint32_t id;
 	std::string name;
 	decltype(BitmaskFlag(MaterialDataAttribute::NONE)) attributes;
 	std::uint8_t illuminationModel;
@@ -158,23 +131,32 @@ struct mtl_material_t
 	mtl_color_t transmissionFilter, ambientReflectance, diffuseReflectance, specularReflectance, emissiveReflectance;
 	mtl_map_t ambientMap, diffuseMap, specularMap, emissiveMap, dissolveMap, bumpMap, displacementMap, lightMap;
 	FaceCulling faceCulling;
+	float roughness, metallic, sheen, clearcoatThickness, clearcoatRoughness, anisotropy, anisotropyRotation;
+	mtl_map_t roughnessMap, metallicMap, sheenMap, normalMap;
 
 };
 
+// Every map of a material in the order they are written, and the material data attribute of each.
+static mtl_map_t mtl_material_t::* const MTL_MAPS[] = { &mtl_material_t::ambientMap, &mtl_material_t::diffuseMap, &mtl_material_t::specularMap, &mtl_material_t::emissiveMap, &mtl_material_t::dissolveMap, &mtl_material_t::bumpMap, &mtl_material_t::displacementMap, &mtl_material_t::lightMap, &mtl_material_t::roughnessMap, &mtl_material_t::metallicMap, &mtl_material_t::sheenMap, &mtl_material_t::normalMap };
+static const MaterialDataAttribute MTL_MAP_ATTRIBUTES[] = { MaterialDataAttribute::AMBIENT_MAP, MaterialDataAttribute::DIFFUSE_MAP, MaterialDataAttribute::SPECULAR_MAP, MaterialDataAttribute::EMISSIVE_MAP, MaterialDataAttribute::DISSOLVE_MAP, MaterialDataAttribute::BUMP_MAP, MaterialDataAttribute::DISPLACEMENT_MAP, MaterialDataAttribute::LIGHT_MAP, MaterialDataAttribute::ROUGHNESS_MAP, MaterialDataAttribute::METALLIC_MAP, MaterialDataAttribute::SHEEN_MAP, MaterialDataAttribute::NORMAL_MAP };
+
 struct mtl_state_t
 {
-	std::string name;
-	std::map<std::uint16_t, std::shared_ptr<mtl_material_t>> materials;
+	std::string name, filePath;
+	std::uint64_t contentHash = 0;
+	std::map<std::uint32_t, std::shared_ptr<mtl_material_t>> materials;
+	std::unordered_map<std::string, std::uint32_t> materialIds; // Name to the ID of the first material declared with it
 
 };
 
 // OBJ Properties
 struct obj_group_t
 {
-	std::uint16_t materialId;
+	std::uint32_t materialId;
 	std::string name, materialName;
 	std::uint8_t smoothing = 1;
 	std::vector<obj_face3_t> faces;
+	obj_bounds_t bounds;
 
 };
 
@@ -183,15 +165,20 @@ struct obj_object_t
 	std::vector<obj_vector3_t> positions;
 	std::vector<obj_vector3_t> normals;
 	std::vector<obj_vector2_t> uvs, uvs2;
+	std::vector<obj_vector4_t> tangents; // Tangent direction with bitangent handedness in w
 	std::vector<std::shared_ptr<obj_group_t>> groups;
+	obj_bounds_t bounds;
+	std::size_t section = 0; // Section of the OBJ file the object was read from
+	bool reused = false; // Taken from the previous conversion with its vertices already transformed, welded and given normals and tangents
 
 };
 
 struct obj_state_t
 {
-	std::uint16_t materialId;
+	std::uint32_t materialId;
 	std::string materialFileName, materialName;
 	std::vector<std::shared_ptr<obj_object_t>> objects;
+	std::vector<std::uint64_t> sectionFingerprints;
 	std::shared_ptr<mtl_state_t> mtlState;
 	std::uint8_t smoothing = 1;
 
@@ -199,1573 +186,5371 @@ struct obj_state_t
 
 struct bom_asset_t
 {
-	std::string name;
+	std::string name, filePath;
 	std::vector<std::shared_ptr<obj_state_t>> objStates;
 
 };
 
-std::vector<std::shared_ptr<mtl_state_t>> mtlStates;
-std::uint16_t maxMaterialId = 0;
+// Scene BVH
+// Nodes are stored depth-first, so the first child of an interior node immediately follows it.
+struct alignas(1) bvh_node_t
+{
+	obj_vector3_t min, max;
+	std::uint32_t offset; // Leaf: Index of the first primitive, Interior: Index of the second child
+	std::uint16_t primitiveCount; // Zero for interior nodes
+	std::uint8_t axis, padding;
+
+};
+
+// Primitives reference a triangle range of a group, where objects are numbered in file order across all assets.
+struct alignas(1) bvh_primitive_t
+{
+	std::uint32_t objectIndex, groupIndex, firstTriangle, triangleCount;
+
+};
+
+static_assert(sizeof(bvh_node_t) == 32 && sizeof(bvh_primitive_t) == 16, "BVH structures must be tightly packed");
+
+struct bom_bvh_t
+{
+	std::vector<bvh_node_t> nodes;
+	std::vector<bvh_primitive_t> primitives;
+
+};
+
+// Conversion state is per thread so that batch jobs can run concurrently on the worker pool.
+thread_local std::vector<std::shared_ptr<mtl_state_t>> mtlStates;
+thread_local std::uint32_t maxMaterialId = 0;
+
+// Parsed MTL libraries shared across conversions, keyed by resolved file path.  Only the latest content of each file is kept, so that the
+// cache of a long-running daemon grows with the number of libraries rather than with every edit made to them.
+std::map<std::string, std::shared_ptr<const mtl_state_t>> mtlCache;
+std::mutex mtlCacheMutex;
 
 bool createIndexedGeometry = true;
 bool logWarnings = true;
 bool logErrors = true;
+bool mergeMaterials = false;
+bool mergeGroups = false;
+std::size_t mergeObjectVertices = 0;
+float weldTolerance = -1.0f;
+bool flipV = false;
+bool zUpToYUp = false;
+float unitScale = 1.0f;
+bool normalizeNormals = false;
+bool generateNormals = false;
+bool angleWeightedNormals = false;
+float creaseAngle = 180.0f;
+bool generateTangents = false;
+bool computeBounds = false;
+bool buildBVH = false;
+std::size_t bvhTriangleThreshold = 0;
+bool readNormals = true;
+bool readUVs = true;
+bool readUV2s = true;
+bool writeStringTable = false;
+std::uint8_t formatVersion = BOM_LEGACY_DATA_VERSION;
+bool deterministicOutput = false;
+bool writeContentHash = false;
+bool checkTextures = false;
+bool writeDependencies = false;
+bool verifyOutput = false;
+bool incrementalConversion = false;
+int benchmarkIterations = 0;
+unsigned int workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+// Log output is buffered per job while running on the worker pool and flushed as one block when the job completes.
+thread_local std::ostringstream jobLog;
+thread_local bool bufferLog = false;
+std::mutex logMutex;
+
+// Log output of jobs run by the daemon is streamed to the client that requested them instead.
+thread_local std::ostream *clientLog = nullptr;
+
+std::ostream &Log()
+{
+	if(clientLog) return *clientLog;
+	if(bufferLog) return jobLog;
+	return std::cout;
 
-bool WriteBOM(const std::vector<std::shared_ptr<bom_asset_t>> &assets, const std::string &bomFilePath)
+}
+
+void FlushLog()
 {
-	std::cout << "Writing BOM '" << bomFilePath << "'..." << std::endl;
+	if(!bufferLog) return;
 
-	// BOM Writer
-	std::ofstream bomFile;
-	bomFile.open(bomFilePath, std::ios::out | std::ios::binary);
-	if(!bomFile.is_open()) return false;
+	std::lock_guard<std::mutex> lock(logMutex);
+	std::cout << jobLog.str() << std::flush;
+	jobLog.str(std::string());
+	jobLog.clear();
 
-	// File Signature
-	std::string fileSignature = "BOM";
-	bomFile.write(fileSignature.c_str(), fileSignature.size());
+}
 
-	// Version
-	std::uint8_t version = BOM_DATA_VERSION;
-	bomFile.write(reinterpret_cast<char*>(&version), sizeof(version));
+// Threads a conversion may use for its own parallel work, including the thread running it.  Conversions running on a worker pool share the
+// workers between them, so that a pool of conversions stays within --jobs threads rather than each of them fanning out to every worker.
+thread_local unsigned int conversionThreadCount = 0;
 
-	// File Data Attributes
-	auto fileAttributes = BitmaskFlag(FileDataAttribute::NONE);
-	if(!mtlStates.empty() && !mtlStates[0]->materials.empty()) fileAttributes |= BitmaskFlag(FileDataAttribute::MATERIAL_LIBRARY);
-	bomFile.write(reinterpret_cast<char*>(&fileAttributes), sizeof(fileAttributes));
+unsigned int ConversionThreadCount()
+{
+	return conversionThreadCount > 0 ? conversionThreadCount : std::max(1u, workerCount);
 
-	if(fileAttributes & BitmaskFlag(FileDataAttribute::MATERIAL_LIBRARY))
+}
+
+class WorkerPool
+{
+public:
+	explicit WorkerPool(unsigned int threadCount)
 	{
-		// Material Count
-		std::uint16_t materialCount = 0;
-		for(const auto &mtlState : mtlStates) materialCount += mtlState->materials.size();
-		bomFile.write(reinterpret_cast<char*>(&materialCount), sizeof(materialCount));
+		threadCount = std::max(1u, threadCount);
+		const unsigned int threadShare = std::max(1u, workerCount / threadCount);
+		for(unsigned int i = 0; i < threadCount; ++i) threads.emplace_back([this, threadShare] { conversionThreadCount = threadShare; Run(); });
+
+	}
 
-		for(const auto &mtlState : mtlStates)
+	~WorkerPool()
+	{
 		{
-			for(const auto &material : mtlState->materials)
-			{
-				// Material Data Attributes
-				auto materialAttributes = material.second->attributes;
-				bomFile.write(reinterpret_cast<char*>(&materialAttributes), sizeof(materialAttributes));
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
 
-				// Material Name
-				std::uint16_t materialNameLength = material.second->name.size();
-				bomFile.write(reinterpret_cast<char*>(&materialNameLength), sizeof(materialNameLength));
-				bomFile.write(material.second->name.c_str(), materialNameLength);
+		}
 
-				// Illumination Model (illum)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::ILLUMINATION_MODEL)) bomFile.write(reinterpret_cast<char*>(&material.second->illuminationModel), sizeof(material.second->illuminationModel));
+		taskReady.notify_all();
+		for(auto &thread : threads) thread.join();
 
-				// Specular Exponent (Ns)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_EXPONENT)) bomFile.write(reinterpret_cast<char*>(&material.second->specularExponent), sizeof(material.second->specularExponent));
+	}
 
-				// Optical Density (Ni)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::OPTICAL_DENSITY)) bomFile.write(reinterpret_cast<char*>(&material.second->opticalDensity), sizeof(material.second->opticalDensity));
+	void Submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+			++pendingTasks;
 
-				// Dissolve (d / [1 - Tr])
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DISSOLVE)) bomFile.write(reinterpret_cast<char*>(&material.second->dissolve), sizeof(material.second->dissolve));
+		}
 
-				// Transmission Filter (Tf)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::TRANSMISSION_FILTER)) bomFile.write(reinterpret_cast<char*>(&material.second->transmissionFilter), sizeof(material.second->transmissionFilter));
+		taskReady.notify_one();
 
-				// Ambient Reflectance (Ka)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::AMBIENT_REFLECTANCE)) bomFile.write(reinterpret_cast<char*>(&material.second->ambientReflectance), sizeof(material.second->ambientReflectance));
+	}
 
-				// Diffuse Reflectance (Kd)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DIFFUSE_REFLECTANCE)) bomFile.write(reinterpret_cast<char*>(&material.second->diffuseReflectance), sizeof(material.second->diffuseReflectance));
+	// Blocks until every submitted task has completed.
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		tasksDone.wait(lock, [this] { return pendingTasks == 0; });
 
-				// Specular Reflectance (Ks)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_REFLECTANCE)) bomFile.write(reinterpret_cast<char*>(&material.second->specularReflectance), sizeof(material.second->specularReflectance));
+	}
 
-				// Emissive Reflectance (Ke)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::EMISSIVE_REFLECTANCE)) bomFile.write(reinterpret_cast<char*>(&material.second->emissiveReflectance), sizeof(material.second->emissiveReflectance));
+private:
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable taskReady, tasksDone;
+	std::size_t pendingTasks = 0;
+	bool stopping = false;
 
-				// Ambient Map (map_Ka)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::AMBIENT_MAP))
-				{
-					const auto map = &material.second->ambientMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+	void Run()
+	{
+		while(true)
+		{
+			std::function<void()> task;
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				taskReady.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if(tasks.empty()) return;
 
-				}
-				
-				// Diffuse Map (map_Kd)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DIFFUSE_MAP))
-				{
-					const auto map = &material.second->diffuseMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+				task = std::move(tasks.front());
+				tasks.pop_front();
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
+			}
 
-				}
-				
-				// Specular Map (map_Kd)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_MAP))
-				{
-					const auto map = &material.second->specularMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+			task();
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if(--pendingTasks == 0) tasksDone.notify_all();
 
-				}
-				
-				// Emissive Map (map_Ke)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::EMISSIVE_MAP))
-				{
-					const auto map = &material.second->emissiveMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+			}
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
+		}
 
-				}
-				
-				// Dissolve Map (map_d)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DISSOLVE_MAP))
-				{
-					const auto map = &material.second->dissolveMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+	}
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
+};
 
-				}
-				
-				// Bump Map (map_bump / bump)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::BUMP_MAP))
-				{
-					const auto map = &material.second->bumpMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+bool ReadFile(const std::string &filePath, std::string &content)
+{
+	std::ifstream file(filePath, std::ios::in | std::ios::binary);
+	if(!file.is_open()) return false;
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
-					
-					// Map Bump Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::BUMP_SCALE)) bomFile.write(reinterpret_cast<char*>(&map->bumpScale), sizeof(map->bumpScale));
+	content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return !file.bad();
 
-				}
-				
-				// Displacement Map (map_disp / disp)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP))
-				{
-					const auto map = &material.second->displacementMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+}
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
-					
-					// Map Displacement Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::BUMP_SCALE)) bomFile.write(reinterpret_cast<char*>(&map->displacementScale), sizeof(map->displacementScale));
+// Asynchronous File I/O
+// Stream buffers that move file reads and writes on to a dedicated thread in fixed-size blocks, so that parsing an OBJ file overlaps reading
+// the rest of it and serializing a BOM overlaps writing what has already been serialized.  At most a few blocks are queued at once.
+const std::size_t ioBlockSize = 1 << 20;
+const std::size_t ioQueuedBlocks = 4;
 
-				}
+class BlockQueue
+{
+public:
+	// Blocks while the queue is full, returns false once the queue has been closed.
+	bool Push(std::vector<char> &&block)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		blockPopped.wait(lock, [this] { return closed || blocks.size() < ioQueuedBlocks; });
+		if(closed) return false;
 
-				// Face Culling (cull_face)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::FACE_CULLING)) bomFile.write(reinterpret_cast<char*>(&material.second->faceCulling), sizeof(material.second->faceCulling));
+		blocks.push_back(std::move(block));
+		blockPushed.notify_one();
+		return true;
 
-				// Light Map (lightmap)
-				if(materialAttributes & BitmaskFlag(MaterialDataAttribute::LIGHT_MAP))
-				{
-					const auto map = &material.second->lightMap;
-
-					// Map Data Attributes
-					auto mapAttributes = map->attributes;
-					bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
-					
-					// Map Path
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::PATH))
-					{
-						std::uint16_t pathCount = map->path.size();
-						bomFile.write(reinterpret_cast<char*>(&pathCount), sizeof(pathCount));
-						bomFile.write(map->path.c_str(), pathCount);
+	}
 
-					}
-					
-					// Map Scale
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->scale), sizeof(map->scale));
-					
-					// Map Offset
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<char*>(&map->offset), sizeof(map->offset));
-					
-					// Light Map Intensity
-					if(mapAttributes & BitmaskFlag(MapDataAttribute::LIGHTMAP_INTENSITY)) bomFile.write(reinterpret_cast<char*>(&map->lightmapIntensity), sizeof(map->lightmapIntensity));
+	// Blocks while the queue is empty, returns false once the queue has been closed and drained.
+	bool Pop(std::vector<char> &block)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		blockPushed.wait(lock, [this] { return closed || !blocks.empty(); });
+		if(blocks.empty()) return false;
 
-				}
+		block = std::move(blocks.front());
+		blocks.pop_front();
+		blockPopped.notify_one();
+		return true;
 
-			}
+	}
+
+	void Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			closed = true;
 
 		}
 
+		blockPushed.notify_all();
+		blockPopped.notify_all();
+
 	}
 
-	// Asset Count
-	std::uint16_t assetCount = assets.size();
-	bomFile.write(reinterpret_cast<char*>(&assetCount), sizeof(assetCount));
+private:
+	std::deque<std::vector<char>> blocks;
+	std::mutex mutex;
+	std::condition_variable blockPushed, blockPopped;
+	bool closed = false;
 
-	for(const auto &asset : assets)
-	{
-		// Asset Data Attributes
-		auto assetAttributes = BitmaskFlag(AssetDataAttribute::NONE);
-		if(!asset->name.empty()) assetAttributes |= BitmaskFlag(AssetDataAttribute::NAME);
-		bomFile.write(reinterpret_cast<char*>(&assetAttributes), sizeof(assetAttributes));
+};
 
-		// Asset Name
-		if(assetAttributes & BitmaskFlag(AssetDataAttribute::NAME))
-		{
-			std::uint16_t assetNameLength = asset->name.size();
-			bomFile.write(reinterpret_cast<char*>(&assetNameLength), sizeof(assetNameLength));
-			bomFile.write(asset->name.c_str(), assetNameLength);
+// Input stream buffer filled by a reader thread that stays up to a few blocks ahead of the parser.  Files are read in text mode, as they
+// were by std::ifstream, so line endings are translated the same way.
+class AsyncReadBuffer : public std::streambuf
+{
+public:
+	~AsyncReadBuffer()
+	{
+		queue.Close();
+		if(thread.joinable()) thread.join();
 
-		}
+	}
 
-		// Object Count
-		std::uint16_t objectCount = 0;
-		for(const auto &objState : asset->objStates) objectCount += objState->objects.size();
-		bomFile.write(reinterpret_cast<char*>(&objectCount), sizeof(objectCount));
+	bool Open(const std::string &filePath)
+	{
+		file.open(filePath);
+		if(!file.is_open()) return false;
 
-		for(const auto &objState : asset->objStates)
-		{
-			for(const auto &object : objState->objects)
-			{
-				// Object Data Attributes
-				auto objectAttributes = BitmaskFlag(ObjectDataAttribute::NONE);
-				if(!object->positions.empty()) objectAttributes |= BitmaskFlag(ObjectDataAttribute::GEOMETRY);
-				bomFile.write(reinterpret_cast<char*>(&objectAttributes), sizeof(objectAttributes));
+		thread = std::thread([this] { Read(); });
+		return true;
 
-				if(objectAttributes & BitmaskFlag(ObjectDataAttribute::GEOMETRY))
-				{
-					// Geometry Data Attributes
-					auto geometryAttributes = BitmaskFlag(GeometryDataAttribute::NONE);
-					if(!object->normals.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::NORMAL);
-					if(!object->uvs.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::UV);
-					if(!object->uvs2.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::UV2);
-					bomFile.write(reinterpret_cast<char*>(&geometryAttributes), sizeof(geometryAttributes));
+	}
 
-					// Vertex Count
-					std::uint32_t vertexCount = object->positions.size();
-					bomFile.write(reinterpret_cast<char*>(&vertexCount), sizeof(vertexCount));
+protected:
+	int_type underflow() override
+	{
+		if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+		if(!queue.Pop(block)) return traits_type::eof();
 
-					// Vertex Positions
-					bomFile.write(reinterpret_cast<char*>(object->positions.data()), sizeof(float) * vertexCount * 3);
+		setg(block.data(), block.data(), block.data() + block.size());
+		return traits_type::to_int_type(*gptr());
 
-					// Vertex Normals
-					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::NORMAL)) bomFile.write(reinterpret_cast<char*>(object->normals.data()), sizeof(float) * vertexCount * 3);
+	}
 
-					// Vertex UVs
-					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV)) bomFile.write(reinterpret_cast<char*>(object->uvs.data()), sizeof(float) * vertexCount * 2);
-					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV2)) bomFile.write(reinterpret_cast<char*>(object->uvs2.data()), sizeof(float) * vertexCount * 2);
+private:
+	std::ifstream file;
+	std::thread thread;
+	BlockQueue queue;
+	std::vector<char> block;
 
-				}
+	void Read()
+	{
+		while(true)
+		{
+			std::vector<char> data(ioBlockSize);
+			file.read(data.data(), data.size());
+			data.resize(static_cast<std::size_t>(file.gcount()));
+			if(data.empty() || !queue.Push(std::move(data))) break;
 
-				// Group Count
-				std::uint16_t groupCount = object->groups.size();
-				bomFile.write(reinterpret_cast<char*>(&groupCount), sizeof(groupCount));
+		}
 
-				for(const auto &group : object->groups)
-				{
-					// Group Data Attributes
-					auto groupAttributes = BitmaskFlag(GroupDataAttribute::NONE);
-					if(!group->name.empty()) groupAttributes |= BitmaskFlag(GroupDataAttribute::NAME);
-					if(!group->faces.empty()) groupAttributes |= BitmaskFlag(GroupDataAttribute::INDEX);
-					if(group->smoothing >= 0) groupAttributes |= BitmaskFlag(GroupDataAttribute::SMOOTHING);
-					if(!group->materialName.empty() && objState->mtlState && objState->mtlState->materials.find(group->materialId) != objState->mtlState->materials.end()) groupAttributes |= BitmaskFlag(GroupDataAttribute::MATERIAL);
-					bomFile.write(reinterpret_cast<char*>(&groupAttributes), sizeof(groupAttributes));
+		queue.Close();
 
-					// Group Name
-					if(groupAttributes & BitmaskFlag(GroupDataAttribute::NAME))
-					{
-						std::uint16_t groupNameLength = group->name.size();
-						bomFile.write(reinterpret_cast<char*>(&groupNameLength), sizeof(groupNameLength));
-						bomFile.write(group->name.c_str(), groupNameLength);
+	}
 
-					}
+};
 
-					if(objectAttributes & BitmaskFlag(ObjectDataAttribute::GEOMETRY))
-					{
-						// Indices
-						if(groupAttributes & BitmaskFlag(GroupDataAttribute::INDEX))
-						{
-							// Index Count
-							std::uint32_t indexCount = group->faces.size() * 3;
-							bomFile.write(reinterpret_cast<char*>(&indexCount), sizeof(indexCount));
+// Output stream buffer drained by a writer thread.  Positions reported through tellp() count every byte serialized so far.  The writer thread
+// hashes the file and each section of it as it writes them, so that hashes of the output need not read it back.
+class AsyncWriteBuffer : public std::streambuf
+{
+public:
+	~AsyncWriteBuffer()
+	{
+		Close();
 
-							// Indices
-							bomFile.write(reinterpret_cast<char*>(group->faces.data()), sizeof(obj_index_t) * indexCount);
+	}
 
-						}
+	bool Open(const std::string &filePath)
+	{
+		file.open(filePath, std::ios::out | std::ios::binary);
+		if(!file.is_open()) return false;
 
-						// Smoothing
-						if(groupAttributes & BitmaskFlag(GroupDataAttribute::SMOOTHING)) bomFile.write(reinterpret_cast<char*>(&group->smoothing), sizeof(group->smoothing));
+		NextBlock();
+		thread = std::thread([this] { Write(); });
+		return true;
 
-						if(groupAttributes & BitmaskFlag(GroupDataAttribute::MATERIAL))
-						{
-							// Material ID
-							std::uint16_t materialId = objState->mtlState->materials[group->materialId]->id;
-							bomFile.write(reinterpret_cast<char*>(&materialId), sizeof(materialId));
+	}
 
-						}
+	// Writes any remaining data and waits for the writer thread, returning false if any write failed.
+	bool Close()
+	{
+		if(!thread.joinable()) return !failed;
 
-					}
+		if(!Submit()) failed = true;
+		queue.Close();
+		thread.join();
 
-				}
+		file.close();
+		if(!file) failed = true;
+		sectionHashes.push_back(sectionHash.Digest());
+		return !failed;
 
-			}
+	}
 
-		}
+	// Starts a section at the current position.  The block serialized so far is submitted early, with an empty block marking the boundary,
+	// so that every block the writer thread receives lies within one section.
+	void BeginSection()
+	{
+		if(!Submit() || !queue.Push(std::vector<char>())) failed = true;
+		NextBlock();
 
 	}
 
-	bomFile.close();
-	return true;
+	// Available once closed: the XXH64 of every section in file order, the first one starting at the beginning of the file, and the hash of
+	// the whole file, which data appended to the file afterwards can continue.
+	const std::vector<std::uint64_t> &SectionHashes() const { return sectionHashes; }
+	const HashXXH64Stream &FileHash() const { return fileHash; }
 
-}
+protected:
+	int_type overflow(int_type character) override
+	{
+		if(!Submit()) return traits_type::eof();
+		NextBlock();
 
-bool ReadMTL(const std::string &relativePath, std::shared_ptr<obj_state_t> objState)
-{
-	// MTL Parser
-	std::ifstream mtlFile(relativePath + objState->materialFileName);
-	if(!mtlFile.is_open()) return false;
+		if(traits_type::eq_int_type(character, traits_type::eof())) return traits_type::not_eof(character);
 
-	auto mtlState = std::make_shared<mtl_state_t>();
-	mtlStates.push_back(mtlState);
-	objState->mtlState = mtlState;
+		*pptr() = traits_type::to_char_type(character);
+		pbump(1);
+		return character;
 
-	mtlState->name = objState->materialFileName;
+	}
 
-	std::shared_ptr<mtl_material_t> material = std::make_shared<mtl_material_t>();
-	material->id = maxMaterialId++;
+	pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override
+	{
+		if(offset != 0 || direction != std::ios_base::cur || !(mode & std::ios_base::out)) return pos_type(off_type(-1));
+		return pos_type(static_cast<off_type>(submittedSize + (pptr() - pbase())));
 
-	std::cout << "Parsing MTL '" << objState->materialFileName << "'..." << std::endl;
-	std::string line;
-	int lineNo = -1;
+	}
 
-	while(std::getline(mtlFile, line))
+private:
+	std::ofstream file;
+	std::thread thread;
+	BlockQueue queue;
+	std::vector<char> block;
+	std::uint64_t submittedSize = 0;
+	std::atomic<bool> failed { false };
+	HashXXH64Stream fileHash, sectionHash;
+	std::vector<std::uint64_t> sectionHashes;
+
+	void NextBlock()
 	{
-		++lineNo;
-		std::istringstream iss(line);
-		//std::cout << line << "\n";
-		if(line.empty()) continue;
+		block.resize(ioBlockSize);
+		setp(block.data(), block.data() + block.size());
 
-		std::string entryType;
-		if(!(iss >> entryType))
-		{
-			if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Failed to parse entry type." << std::endl;
-			break;
+	}
 
-		}
+	bool Submit()
+	{
+		block.resize(pptr() - pbase());
+		submittedSize += block.size();
+		setp(nullptr, nullptr);
 
-		if(entryType == "#")
+		return failed ? false : block.empty() || queue.Push(std::move(block));
+
+	}
+
+	void Write()
+	{
+		std::vector<char> data;
+		while(queue.Pop(data))
 		{
-			// Attempt to parse out vendor-specific material property
-			// # :<vendor>: <property> [value0] [value1] [valueN...]
-			if((iss >> entryType) && entryType == ":BOM:")
+			if(data.empty())
 			{
-				if(!(iss >> entryType))
-				{
-					if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific material entry type could not be parsed and will be skipped." << std::endl;
-					continue;
+				sectionHashes.push_back(sectionHash.Digest());
+				sectionHash = HashXXH64Stream();
+				continue;
 
-				}
+			}
 
-				if(entryType == "cull_face")
-				{
-					// Face Culling Preference (cull_face)
-					// :BOM: cull_face <none|front|back|all>
-					// none (0x00): No face culling is applied.
-					// front (0x01): Front faces are culled.
-					// back (0x02): Back faces are culled.
-					// all (0x03): Both front and back faces are culled.
-					std::string faceCulling;
-					if(!(iss >> faceCulling))
-					{
-						if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType << "' could not be parsed and will be skipped." << std::endl;
-						continue;
+			fileHash.Update(data.data(), data.size());
+			sectionHash.Update(data.data(), data.size());
+			file.write(data.data(), data.size());
+			if(!file)
+			{
+				failed = true;
+				queue.Close();
+				break;
 
-					}
-					else if(faceCulling == "none")
-					{
-						material->faceCulling = FaceCulling::NONE;
+			}
 
-					}
-					else if(faceCulling == "front")
-					{
-						material->faceCulling = FaceCulling::FRONT;
+		}
 
-					}
-					else if(faceCulling == "back")
-					{
-						material->faceCulling = FaceCulling::BACK;
+	}
 
-					}
-					else if(faceCulling == "all")
-					{
-						material->faceCulling = FaceCulling::ALL;
+};
 
-					}
-					else
-					{
-						if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType << "' has unsupported value will be skipped." << std::endl;
-						continue;
+// Hints the operating system to start reading a file in to the page cache in the background, so that input files queued behind the one
+// being parsed are already resident by the time they are opened.
+void PrefetchFile(const std::string &filePath)
+{
+#if !defined(_WIN32) && defined(POSIX_FADV_WILLNEED)
+	int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+	if(fileDescriptor < 0) return;
 
-					}
+	posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_WILLNEED);
+	close(fileDescriptor);
+#else
+	(void)filePath;
+#endif
 
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::FACE_CULLING);
+}
 
-				}
-				else if(entryType == "lightmap")
-				{
-					// Light Map (lightmap)
-					// :BOM: lightmap [-o <offset_u> <offset_v>] [-s <scale_u> <scale_v>] [-intensity <intensity_modifier>] <path>
-
-					// Texture Offset
-					// -o <offset_u> <offset_v>
-					// Specifies UV offset of the light map texture.
-
-					// Texture Scale
-					// -s <scale_u> <scale_v>
-					// Specifies UV scaling of the light map texture.
-
-					// Lightmap Intensity Option
-					// -intensity <intensity_modifier>
-					// Intensity modifier to be applied to the light map, where a larger modifier produces a greater intensity. Defaults to 1.
-
-					// Lightmap Path
-					// <path>
-					// File path of the light map texture file.
-					std::string optionType;
-					while((iss >> optionType))
-					{
-						if(optionType == "-intensity")
-						{
-							if(!(iss >> material->lightMap.lightmapIntensity))
-							{
-								if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType << "' could not be parsed and will be skipped." << std::endl;
-								break;
+// String Table
+// Unique names and paths in order of first use, which string fields then reference by index instead of storing inline.
+struct bom_string_table_t
+{
+	std::vector<const std::string*> strings;
+	std::unordered_map<std::string, std::uint32_t> indices;
 
-							}
+	void Add(const std::string &string)
+	{
+		if(indices.insert(std::make_pair(string, static_cast<std::uint32_t>(strings.size()))).second) strings.push_back(&string);
 
-							material->lightMap.attributes |= BitmaskFlag(MapDataAttribute::LIGHTMAP_INTENSITY);
-							material->attributes |= BitmaskFlag(MaterialDataAttribute::LIGHT_MAP);
+	}
 
-						}
-						else if(optionType == "-o")
-						{
-							if(!(iss >> material->lightMap.offset.x >> material->lightMap.offset.y))
-							{
-								if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType << "' could not be parsed and will be skipped." << std::endl;
-								break;
+};
 
-							}
+// Writes a count, length or index as a variable-length integer, or as a fixed-size integer of type T when writing version 1 files.
+// Returns false if the value does not fit in a version 1 field, rather than silently truncating it.
+template <typename T>
+bool WriteCount(std::ostream &bomFile, std::uint64_t value)
+{
+	if(formatVersion == BOM_LEGACY_DATA_VERSION)
+	{
+		if(value > std::numeric_limits<T>::max()) return false;
 
-							material->lightMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-							material->attributes |= BitmaskFlag(MaterialDataAttribute::LIGHT_MAP);
+		T fixedValue = static_cast<T>(value);
+		bomFile.write(reinterpret_cast<char*>(&fixedValue), sizeof(fixedValue));
+		return true;
 
-						}
-						else if(optionType == "-s")
-						{
-							if(!(iss >> material->lightMap.scale.x >> material->lightMap.scale.y))
-							{
-								if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType << "' could not be parsed and will be skipped." << std::endl;
-								break;
+	}
 
-							}
+	char bytes[BOM_VARINT_MAX_SIZE];
+	std::size_t size = 0;
 
-							material->lightMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-							material->attributes |= BitmaskFlag(MaterialDataAttribute::LIGHT_MAP);
+	do
+	{
+		bytes[size++] = static_cast<char>((value & 0x7F) | (value > 0x7F ? 0x80 : 0));
+		value >>= 7;
 
-						}
-						else
-						{
-							material->lightMap.path = optionType;
-							material->lightMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-							material->attributes |= BitmaskFlag(MaterialDataAttribute::LIGHT_MAP);
-							break;
+	}
+	while(value);
 
-						}
+	bomFile.write(bytes, size);
+	return true;
 
-					}
+}
 
-				}
+// Writes a string as a length-prefixed string, or as its index in the string table when one is given.
+bool WriteString(std::ostream &bomFile, const std::string &string, const bom_string_table_t *stringTable = nullptr)
+{
+	if(stringTable) return WriteCount<std::uint32_t>(bomFile, stringTable->indices.at(string));
 
-			}
+	if(!WriteCount<std::uint16_t>(bomFile, string.size())) return false;
+	bomFile.write(string.c_str(), string.size());
+	return true;
 
-			continue;
+}
 
-		}
-		else if(entryType == "newmtl")
-		{
-			if(!mtlState->materials.empty())
-			{
-				material = std::make_shared<mtl_material_t>();
-				material->id = maxMaterialId++;
+// Returns the attributes of a map or material written to the output, leaving out those that the format version does not define.
+decltype(mtl_map_t::attributes) WrittenAttributes(const mtl_map_t &map)
+{
+	return formatVersion == BOM_LEGACY_DATA_VERSION ? map.attributes & BOM_LEGACY_MAP_ATTRIBUTES : map.attributes;
 
-			}
+}
 
-			if(!(iss >> material->name))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+decltype(mtl_material_t::attributes) WrittenAttributes(const mtl_material_t &material)
+{
+	return formatVersion == BOM_LEGACY_DATA_VERSION ? material.attributes & BOM_LEGACY_MATERIAL_ATTRIBUTES : material.attributes;
 
-			}
+}
 
-			mtlState->materials.insert(std::make_pair(material->id, material));
+bool WriteMap(std::ostream &bomFile, const mtl_map_t &map, const bom_string_table_t *stringTable = nullptr)
+{
+	// Map Data Attributes
+	auto mapAttributes = WrittenAttributes(map);
+	bomFile.write(reinterpret_cast<char*>(&mapAttributes), sizeof(mapAttributes));
 
-		}
-		else if(entryType == "illum")
-		{
-			if(!(iss >> material->illuminationModel))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Map Path
+	if((mapAttributes & BitmaskFlag(MapDataAttribute::PATH)) && !WriteString(bomFile, map.path, stringTable)) return false;
 
-			}
+	// Map Scale
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::SCALE)) bomFile.write(reinterpret_cast<const char*>(&map.scale), sizeof(map.scale));
 
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::ILLUMINATION_MODEL);
+	// Map Offset
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::OFFSET)) bomFile.write(reinterpret_cast<const char*>(&map.offset), sizeof(map.offset));
 
-		}
-		else if(entryType == "Ns")
-		{
-			if(!(iss >> material->specularExponent))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Map Bump Scale
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::BUMP_SCALE)) bomFile.write(reinterpret_cast<const char*>(&map.bumpScale), sizeof(map.bumpScale));
 
-			}
+	// Map Displacement Scale
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::DISPLACEMENT_SCALE)) bomFile.write(reinterpret_cast<const char*>(&map.displacementScale), sizeof(map.displacementScale));
 
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::SPECULAR_EXPONENT);
+	// Light Map Intensity
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::LIGHTMAP_INTENSITY)) bomFile.write(reinterpret_cast<const char*>(&map.lightmapIntensity), sizeof(map.lightmapIntensity));
 
-		}
-		else if(entryType == "Ni")
-		{
-			if(!(iss >> material->opticalDensity))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Map Options (-blendu / -blendv / -clamp / -cc)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::OPTIONS)) bomFile.write(reinterpret_cast<const char*>(&map.options), sizeof(map.options));
 
-			}
+	// Map Boost (-boost)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::BOOST)) bomFile.write(reinterpret_cast<const char*>(&map.boost), sizeof(map.boost));
 
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::OPTICAL_DENSITY);
+	// Map Range (-mm)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::RANGE)) bomFile.write(reinterpret_cast<const char*>(&map.range), sizeof(map.range));
 
-		}
-		else if(entryType == "d")
-		{
-			if(!(iss >> material->dissolve))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Map Turbulence (-t)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::TURBULENCE)) bomFile.write(reinterpret_cast<const char*>(&map.turbulence), sizeof(map.turbulence));
 
-			}
+	// Map Resolution (-texres)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::RESOLUTION)) bomFile.write(reinterpret_cast<const char*>(&map.resolution), sizeof(map.resolution));
 
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::DISSOLVE);
+	// Map Channel (-imfchan)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::CHANNEL)) bomFile.write(reinterpret_cast<const char*>(&map.channel), sizeof(map.channel));
 
-		}
-		else if(entryType == "Tr")
-		{
-			if(!(material->attributes & BitmaskFlag(MaterialDataAttribute::DISSOLVE)))
-			{
-				if(!(iss >> material->dissolve))
-				{
-					if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-					break;
+	// Map Projection (-type)
+	if(mapAttributes & BitmaskFlag(MapDataAttribute::PROJECTION)) bomFile.write(reinterpret_cast<const char*>(&map.projection), sizeof(map.projection));
 
-				}
+	return true;
 
-				material->dissolve = 1.0f - material->dissolve;
-				material->attributes |= BitmaskFlag(MaterialDataAttribute::DISSOLVE);
+}
 
-			}
-			else
-			{
-				if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Transparency (Tr) property is non-standard, defaulting to Dissolve (d)." << std::endl;
-				
-			}
+// Writes every material property following the material name, in the order defined by the material data attributes.
+bool WriteMaterialProperties(std::ostream &bomFile, const mtl_material_t &material, const bom_string_table_t *stringTable = nullptr)
+{
+	const auto materialAttributes = WrittenAttributes(material);
 
-		}
-		else if(entryType == "Tf")
-		{
-			if(!(iss >> material->transmissionFilter.r))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Illumination Model (illum)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::ILLUMINATION_MODEL)) bomFile.write(reinterpret_cast<const char*>(&material.illuminationModel), sizeof(material.illuminationModel));
 
-			}
+	// Specular Exponent (Ns)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_EXPONENT)) bomFile.write(reinterpret_cast<const char*>(&material.specularExponent), sizeof(material.specularExponent));
 
-			if(!(iss >> material->transmissionFilter.g >> material->transmissionFilter.b)) material->transmissionFilter.b = material->transmissionFilter.g = material->transmissionFilter.r;
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::TRANSMISSION_FILTER);
+	// Optical Density (Ni)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::OPTICAL_DENSITY)) bomFile.write(reinterpret_cast<const char*>(&material.opticalDensity), sizeof(material.opticalDensity));
 
-		}
-		else if(entryType == "Ka")
-		{
-			if(!(iss >> material->ambientReflectance.r))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Dissolve (d / [1 - Tr])
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DISSOLVE)) bomFile.write(reinterpret_cast<const char*>(&material.dissolve), sizeof(material.dissolve));
 
-			}
-			
-			if(!(iss >> material->ambientReflectance.g >> material->ambientReflectance.b)) material->ambientReflectance.b = material->ambientReflectance.g = material->ambientReflectance.r;
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::AMBIENT_REFLECTANCE);
+	// Transmission Filter (Tf)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::TRANSMISSION_FILTER)) bomFile.write(reinterpret_cast<const char*>(&material.transmissionFilter), sizeof(material.transmissionFilter));
 
-		}
-		else if(entryType == "Kd")
-		{
-			if(!(iss >> material->diffuseReflectance.r))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Ambient Reflectance (Ka)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::AMBIENT_REFLECTANCE)) bomFile.write(reinterpret_cast<const char*>(&material.ambientReflectance), sizeof(material.ambientReflectance));
 
-			}
-			
-			if(!(iss >> material->diffuseReflectance.g >> material->diffuseReflectance.b)) material->diffuseReflectance.b = material->diffuseReflectance.g = material->diffuseReflectance.r;
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::DIFFUSE_REFLECTANCE);
+	// Diffuse Reflectance (Kd)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::DIFFUSE_REFLECTANCE)) bomFile.write(reinterpret_cast<const char*>(&material.diffuseReflectance), sizeof(material.diffuseReflectance));
 
-		}
-		else if(entryType == "Ks")
-		{
-			if(!(iss >> material->specularReflectance.r))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Specular Reflectance (Ks)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_REFLECTANCE)) bomFile.write(reinterpret_cast<const char*>(&material.specularReflectance), sizeof(material.specularReflectance));
 
-			}
-			
-			if(!(iss >> material->specularReflectance.g >> material->specularReflectance.b)) material->specularReflectance.b = material->specularReflectance.g = material->specularReflectance.r;
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::SPECULAR_REFLECTANCE);
+	// Emissive Reflectance (Ke)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::EMISSIVE_REFLECTANCE)) bomFile.write(reinterpret_cast<const char*>(&material.emissiveReflectance), sizeof(material.emissiveReflectance));
 
-		}
-		else if(entryType == "Ke")
-		{
-			if(!(iss >> material->emissiveReflectance.r))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				break;
+	// Ambient Map (map_Ka)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::AMBIENT_MAP)) && !WriteMap(bomFile, material.ambientMap, stringTable)) return false;
 
-			}
-			
-			if(!(iss >> material->emissiveReflectance.g >> material->emissiveReflectance.b)) material->emissiveReflectance.b = material->emissiveReflectance.g = material->emissiveReflectance.r;
-			material->attributes |= BitmaskFlag(MaterialDataAttribute::EMISSIVE_REFLECTANCE);
+	// Diffuse Map (map_Kd)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::DIFFUSE_MAP)) && !WriteMap(bomFile, material.diffuseMap, stringTable)) return false;
 
-		}
-		else if(entryType == "map_Ka")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-o")
-				{
-					if(!(iss >> material->ambientMap.offset.x >> material->ambientMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Specular Map (map_Ks)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::SPECULAR_MAP)) && !WriteMap(bomFile, material.specularMap, stringTable)) return false;
 
-					}
+	// Emissive Map (map_Ke)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::EMISSIVE_MAP)) && !WriteMap(bomFile, material.emissiveMap, stringTable)) return false;
 
-					material->ambientMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::AMBIENT_MAP);
+	// Dissolve Map (map_d)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::DISSOLVE_MAP)) && !WriteMap(bomFile, material.dissolveMap, stringTable)) return false;
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->ambientMap.scale.x >> material->ambientMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Bump Map (map_bump / bump)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::BUMP_MAP)) && !WriteMap(bomFile, material.bumpMap, stringTable)) return false;
 
-					}
+	// Displacement Map (map_disp / disp)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP)) && !WriteMap(bomFile, material.displacementMap, stringTable)) return false;
 
-					material->ambientMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::AMBIENT_MAP);
+	// Face Culling (cull_face)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::FACE_CULLING)) bomFile.write(reinterpret_cast<const char*>(&material.faceCulling), sizeof(material.faceCulling));
 
-				}
-				else
-				{
-					material->ambientMap.path = optionType;
-					material->ambientMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::AMBIENT_MAP);
-					break;
+	// Light Map (lightmap)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::LIGHT_MAP)) && !WriteMap(bomFile, material.lightMap, stringTable)) return false;
 
-				}
+	// Roughness (Pr)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::ROUGHNESS)) bomFile.write(reinterpret_cast<const char*>(&material.roughness), sizeof(material.roughness));
 
-			}
+	// Metallic (Pm)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::METALLIC)) bomFile.write(reinterpret_cast<const char*>(&material.metallic), sizeof(material.metallic));
 
-		}
-		else if(entryType == "map_Kd")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-o")
-				{
-					if(!(iss >> material->diffuseMap.offset.x >> material->diffuseMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Sheen (Ps)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::SHEEN)) bomFile.write(reinterpret_cast<const char*>(&material.sheen), sizeof(material.sheen));
 
-					}
+	// Clearcoat Thickness (Pc)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::CLEARCOAT_THICKNESS)) bomFile.write(reinterpret_cast<const char*>(&material.clearcoatThickness), sizeof(material.clearcoatThickness));
 
-					material->diffuseMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DIFFUSE_MAP);
+	// Clearcoat Roughness (Pcr)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::CLEARCOAT_ROUGHNESS)) bomFile.write(reinterpret_cast<const char*>(&material.clearcoatRoughness), sizeof(material.clearcoatRoughness));
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->diffuseMap.scale.x >> material->diffuseMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Anisotropy (aniso)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::ANISOTROPY)) bomFile.write(reinterpret_cast<const char*>(&material.anisotropy), sizeof(material.anisotropy));
 
-					}
+	// Anisotropy Rotation (anisor)
+	if(materialAttributes & BitmaskFlag(MaterialDataAttribute::ANISOTROPY_ROTATION)) bomFile.write(reinterpret_cast<const char*>(&material.anisotropyRotation), sizeof(material.anisotropyRotation));
 
-					material->diffuseMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DIFFUSE_MAP);
+	// Roughness Map (map_Pr)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::ROUGHNESS_MAP)) && !WriteMap(bomFile, material.roughnessMap, stringTable)) return false;
 
-				}
-				else
-				{
-					material->diffuseMap.path = optionType;
-					material->diffuseMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DIFFUSE_MAP);
-					break;
+	// Metallic Map (map_Pm)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::METALLIC_MAP)) && !WriteMap(bomFile, material.metallicMap, stringTable)) return false;
 
-				}
+	// Sheen Map (map_Ps)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::SHEEN_MAP)) && !WriteMap(bomFile, material.sheenMap, stringTable)) return false;
 
-			}
+	// Normal Map (norm)
+	if((materialAttributes & BitmaskFlag(MaterialDataAttribute::NORMAL_MAP)) && !WriteMap(bomFile, material.normalMap, stringTable)) return false;
 
-		}
-		else if(entryType == "map_Ks")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-o")
-				{
-					if(!(iss >> material->specularMap.offset.x >> material->specularMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	return true;
 
-					}
+}
 
-					material->specularMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::SPECULAR_MAP);
+// Returns the serialized form of a material, covering its attributes bitmask and every property and map it enables but not its name.
+std::string MaterialContent(const mtl_material_t &material)
+{
+	std::ostringstream content;
+	content.write(reinterpret_cast<const char*>(&material.attributes), sizeof(material.attributes));
+	WriteMaterialProperties(content, material);
+	return content.str();
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->specularMap.scale.x >> material->specularMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+}
 
-					}
+// Returns the materials of the current conversion, with the library declaring each, in the order they are written to the material library.
+// Deterministic output orders them by resolved library path, material name and then content, so that neither the order in which OBJ files
+// referenced them nor libraries of the same name in different directories or materials declared twice affect the file.
+std::vector<std::pair<mtl_state_t*, std::shared_ptr<mtl_material_t>>> CollectLibraryMaterialStates()
+{
+	std::vector<std::pair<mtl_state_t*, std::shared_ptr<mtl_material_t>>> libraryMaterials;
+	for(const auto &mtlState : mtlStates)
+	{
+		for(const auto &material : mtlState->materials) libraryMaterials.push_back(std::make_pair(mtlState.get(), material.second));
 
-					material->specularMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::SPECULAR_MAP);
+	}
 
-				}
-				else
-				{
-					material->specularMap.path = optionType;
-					material->specularMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::SPECULAR_MAP);
-					break;
+	if(deterministicOutput)
+	{
+		std::sort(libraryMaterials.begin(), libraryMaterials.end(), [](const auto &a, const auto &b)
+		{
+			if(a.first->filePath != b.first->filePath) return a.first->filePath < b.first->filePath;
+			if(a.second->name != b.second->name) return a.second->name < b.second->name;
+			return MaterialContent(*a.second) < MaterialContent(*b.second);
 
-				}
+		});
 
-			}
+	}
 
-		}
-		else if(entryType == "map_Ke")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-o")
-				{
-					if(!(iss >> material->emissiveMap.offset.x >> material->emissiveMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	return libraryMaterials;
 
-					}
+}
 
-					material->emissiveMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::EMISSIVE_MAP);
+std::vector<std::shared_ptr<mtl_material_t>> CollectLibraryMaterials()
+{
+	std::vector<std::shared_ptr<mtl_material_t>> materials;
+	for(const auto &material : CollectLibraryMaterialStates()) materials.push_back(material.second);
+	return materials;
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->emissiveMap.scale.x >> material->emissiveMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+}
 
-					}
+// Size and XXH64 of a written BOM file
+struct bom_file_digest_t
+{
+	std::uint64_t size = 0, hash = 0;
 
-					material->emissiveMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::EMISSIVE_MAP);
+};
 
-				}
-				else
-				{
-					material->emissiveMap.path = optionType;
-					material->emissiveMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::EMISSIVE_MAP);
-					break;
+// Content Hash Trailer
+// Appends the XXH64 hash of every section of a written BOM and of the whole file, so that files can be compared and checked for integrity
+// without parsing them.  Section boundaries are given as offsets in to the file, in file order, with their hashes taken as the file was written.
+bool WriteContentHash(const std::string &bomFilePath, const std::vector<std::pair<BomSection, std::uint64_t>> &sectionOffsets, const std::vector<std::uint64_t> &sectionHashes, HashXXH64Stream fileHash, bom_file_digest_t &digest)
+{
+	std::ostringstream trailer;
 
-				}
+	// Section Count
+	std::uint32_t sectionCount = sectionOffsets.size();
+	trailer.write(reinterpret_cast<char*>(&sectionCount), sizeof(sectionCount));
 
-			}
+	for(std::size_t i = 0; i < sectionOffsets.size(); ++i)
+	{
+		// Section Type, Offset, Size & Hash
+		std::uint32_t sectionType = static_cast<std::uint32_t>(sectionOffsets[i].first);
+		std::uint64_t sectionOffset = sectionOffsets[i].second;
+		std::uint64_t sectionSize = (i + 1 < sectionOffsets.size() ? sectionOffsets[i + 1].second : fileHash.Size()) - sectionOffset;
+		std::uint64_t sectionHash = sectionHashes[i];
 
-		}
-		else if(entryType == "map_d")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-o")
-				{
-					if(!(iss >> material->dissolveMap.offset.x >> material->dissolveMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+		trailer.write(reinterpret_cast<char*>(&sectionType), sizeof(sectionType));
+		trailer.write(reinterpret_cast<char*>(&sectionOffset), sizeof(sectionOffset));
+		trailer.write(reinterpret_cast<char*>(&sectionSize), sizeof(sectionSize));
+		trailer.write(reinterpret_cast<char*>(&sectionHash), sizeof(sectionHash));
 
-					}
+	}
 
-					material->dissolveMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISSOLVE_MAP);
+	// File Hash, covering everything before it including the section table
+	const auto sectionTable = trailer.str();
+	fileHash.Update(sectionTable.data(), sectionTable.size());
+	std::uint64_t contentHash = fileHash.Digest();
+	trailer.write(reinterpret_cast<char*>(&contentHash), sizeof(contentHash));
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->dissolveMap.scale.x >> material->dissolveMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Trailer Size & Signature
+	std::uint32_t trailerSize = static_cast<std::uint32_t>(trailer.tellp()) + sizeof(trailerSize) + BOM_CONTENT_HASH_SIGNATURE_SIZE;
+	trailer.write(reinterpret_cast<char*>(&trailerSize), sizeof(trailerSize));
+	trailer.write(BOM_CONTENT_HASH_SIGNATURE, BOM_CONTENT_HASH_SIGNATURE_SIZE);
 
-					}
+	std::ofstream bomFile(bomFilePath, std::ios::out | std::ios::binary | std::ios::app);
+	if(!bomFile.is_open()) return false;
 
-					material->dissolveMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISSOLVE_MAP);
+	auto data = trailer.str();
+	bomFile.write(data.data(), data.size());
 
-				}
-				else
-				{
-					material->dissolveMap.path = optionType;
-					material->dissolveMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISSOLVE_MAP);
-					break;
+	fileHash.Update(data.data() + sectionTable.size(), data.size() - sectionTable.size());
+	digest = { fileHash.Size(), fileHash.Digest() };
 
-				}
+	Log() << "Content hash " << std::hex << std::setw(16) << std::setfill('0') << contentHash << std::dec << std::setfill(' ') << "." << std::endl;
+	return bomFile.good();
 
-			}
+}
 
-		}
-		else if(entryType == "map_bump" || entryType == "bump")
-		{
-			std::string optionType;
-			while((iss >> optionType))
-			{
-				if(optionType == "-bm")
-				{
-					if(!(iss >> material->bumpMap.bumpScale))
-					{
-						if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+// Writes the BOM to outputFilePath, reporting errors against bomFilePath.
+bool WriteBOMFile(const std::vector<std::shared_ptr<bom_asset_t>> &assets, const std::string &bomFilePath, const std::string &outputFilePath, const bom_bvh_t *bvh, bom_file_digest_t &digest)
+{
+	// BOM Writer
+	AsyncWriteBuffer bomFileBuffer;
+	if(!bomFileBuffer.Open(outputFilePath)) return false;
+	std::ostream bomFile(&bomFileBuffer);
 
-					}
+	// File Signature
+	std::string fileSignature = "BOM";
+	bomFile.write(fileSignature.c_str(), fileSignature.size());
 
-					material->bumpMap.attributes |= BitmaskFlag(MapDataAttribute::BUMP_SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::BUMP_MAP);
+	// Version
+	std::uint8_t version = formatVersion;
+	bomFile.write(reinterpret_cast<char*>(&version), sizeof(version));
 
-				}
-				else if(optionType == "-o")
-				{
-					if(!(iss >> material->bumpMap.offset.x >> material->bumpMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// Values that do not fit in the fields of the format version being written fail the conversion instead of producing an unreadable file.
+	auto overflow = [&bomFilePath](const std::string &field)
+	{
+		if(logErrors) Log() << "ERROR: [" << bomFilePath << "] " << field << " exceeds the limits of BOM version " << static_cast<int>(formatVersion) << "." << std::endl;
+		return false;
 
-					}
+	};
 
-					material->bumpMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::BUMP_MAP);
+	// Material Count
+	const auto libraryMaterials = CollectLibraryMaterials();
+	const std::size_t materialCount = libraryMaterials.size();
 
-				}
-				else if(optionType == "-s")
-				{
-					if(!(iss >> material->bumpMap.scale.x >> material->bumpMap.scale.y))
-					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+	// File Data Attributes
+	auto fileAttributes = BitmaskFlag(FileDataAttribute::NONE);
+	if(materialCount > 0) fileAttributes |= BitmaskFlag(FileDataAttribute::MATERIAL_LIBRARY);
+	if(bvh && !bvh->nodes.empty()) fileAttributes |= BitmaskFlag(FileDataAttribute::BVH);
+	if(writeStringTable) fileAttributes |= BitmaskFlag(FileDataAttribute::STRING_TABLE);
+	if(writeContentHash) fileAttributes |= BitmaskFlag(FileDataAttribute::CONTENT_HASH);
+	bomFile.write(reinterpret_cast<char*>(&fileAttributes), sizeof(fileAttributes));
 
-					}
+	std::vector<std::pair<BomSection, std::uint64_t>> sectionOffsets { std::make_pair(BomSection::HEADER, std::uint64_t(0)) };
+	auto beginSection = [&](BomSection section)
+	{
+		sectionOffsets.push_back(std::make_pair(section, static_cast<std::uint64_t>(bomFile.tellp())));
+		bomFileBuffer.BeginSection();
 
-					material->bumpMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::BUMP_MAP);
+	};
 
-				}
-				else
+	// String Table
+	bom_string_table_t table;
+	const bom_string_table_t *stringTable = nullptr;
+
+	if(fileAttributes & BitmaskFlag(FileDataAttribute::STRING_TABLE))
+	{
+		beginSection(BomSection::STRING_TABLE);
+
+		// Strings are collected in the order they are written so that readers see them in file order.
+		for(const auto &material : libraryMaterials)
+		{
+			table.Add(material->name);
+
+			for(std::size_t map = 0; map < sizeof(MTL_MAPS) / sizeof(MTL_MAPS[0]); ++map)
+			{
+				const auto &mapData = (*material).*MTL_MAPS[map];
+				if((WrittenAttributes(*material) & BitmaskFlag(MTL_MAP_ATTRIBUTES[map])) && (mapData.attributes & BitmaskFlag(MapDataAttribute::PATH))) table.Add(mapData.path);
+
+			}
+
+		}
+
+		for(const auto &asset : assets)
+		{
+			if(!asset->name.empty()) table.Add(asset->name);
+
+			for(const auto &objState : asset->objStates)
+			{
+				for(const auto &object : objState->objects)
 				{
-					material->bumpMap.path = optionType;
-					material->bumpMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::BUMP_MAP);
-					break;
+					for(const auto &group : object->groups) if(!group->name.empty()) table.Add(group->name);
 
 				}
 
 			}
 
 		}
-		else if(entryType == "map_disp" || entryType == "disp")
+
+		// String Count
+		if(!WriteCount<std::uint32_t>(bomFile, table.strings.size())) return overflow("String count " + std::to_string(table.strings.size()));
+
+		for(const auto *string : table.strings)
+		{
+			if(!WriteString(bomFile, *string)) return overflow("Length of string table entry '" + string->substr(0, 64) + "'");
+
+		}
+
+		stringTable = &table;
+
+	}
+
+	// Material IDs are written as the index of the material within the material library.
+	std::map<std::uint32_t, std::uint32_t> materialIndices;
+
+	if(fileAttributes & BitmaskFlag(FileDataAttribute::MATERIAL_LIBRARY))
+	{
+		beginSection(BomSection::MATERIAL_LIBRARY);
+		if(!WriteCount<std::uint16_t>(bomFile, materialCount)) return overflow("Material count " + std::to_string(materialCount));
+
+		for(const auto &material : libraryMaterials)
+		{
+			materialIndices.insert(std::make_pair(material->id, static_cast<std::uint32_t>(materialIndices.size())));
+
+			// Material Data Attributes
+			auto materialAttributes = WrittenAttributes(*material);
+			bomFile.write(reinterpret_cast<char*>(&materialAttributes), sizeof(materialAttributes));
+
+			// Material Name
+			if(!WriteString(bomFile, material->name, stringTable)) return overflow("Name length of material '" + material->name.substr(0, 64) + "'");
+
+			if(!WriteMaterialProperties(bomFile, *material, stringTable)) return overflow("Texture path length of material '" + material->name + "'");
+
+		}
+
+	}
+
+	// Asset Count
+	beginSection(BomSection::ASSETS);
+	if(!WriteCount<std::uint16_t>(bomFile, assets.size())) return overflow("Asset count " + std::to_string(assets.size()));
+
+	for(const auto &asset : assets)
+	{
+		// Asset Data Attributes
+		auto assetAttributes = BitmaskFlag(AssetDataAttribute::NONE);
+		if(!asset->name.empty()) assetAttributes |= BitmaskFlag(AssetDataAttribute::NAME);
+		bomFile.write(reinterpret_cast<char*>(&assetAttributes), sizeof(assetAttributes));
+
+		// Asset Name
+		if((assetAttributes & BitmaskFlag(AssetDataAttribute::NAME)) && !WriteString(bomFile, asset->name, stringTable)) return overflow("Name length of asset '" + asset->name.substr(0, 64) + "'");
+
+		// Object Count
+		std::size_t objectCount = 0;
+		for(const auto &objState : asset->objStates) objectCount += objState->objects.size();
+		if(!WriteCount<std::uint16_t>(bomFile, objectCount)) return overflow("Object count " + std::to_string(objectCount) + " of asset '" + asset->name + "'");
+
+		for(const auto &objState : asset->objStates)
 		{
-			std::string optionType;
-			while((iss >> optionType))
+			for(const auto &object : objState->objects)
 			{
-				if(optionType == "-o")
+				// Object Data Attributes
+				auto objectAttributes = BitmaskFlag(ObjectDataAttribute::NONE);
+				if(!object->positions.empty()) objectAttributes |= BitmaskFlag(ObjectDataAttribute::GEOMETRY);
+				if(!object->positions.empty() && computeBounds) objectAttributes |= BitmaskFlag(ObjectDataAttribute::BOUNDS);
+				bomFile.write(reinterpret_cast<char*>(&objectAttributes), sizeof(objectAttributes));
+
+				if(objectAttributes & BitmaskFlag(ObjectDataAttribute::GEOMETRY))
 				{
-					if(!(iss >> material->displacementMap.offset.x >> material->displacementMap.offset.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+					// Geometry Data Attributes
+					auto geometryAttributes = BitmaskFlag(GeometryDataAttribute::NONE);
+					if(!object->normals.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::NORMAL);
+					if(!object->uvs.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::UV);
+					if(!object->uvs2.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::UV2);
+					if(!object->tangents.empty()) geometryAttributes |= BitmaskFlag(GeometryDataAttribute::TANGENT);
+					bomFile.write(reinterpret_cast<char*>(&geometryAttributes), sizeof(geometryAttributes));
 
-					}
+					// Vertex Count
+					const std::size_t vertexCount = object->positions.size();
+					if(vertexCount > std::numeric_limits<std::uint32_t>::max() || !WriteCount<std::uint32_t>(bomFile, vertexCount)) return overflow("Vertex count " + std::to_string(vertexCount) + " of an object in asset '" + asset->name + "'");
+
+					// Vertex Positions
+					bomFile.write(reinterpret_cast<char*>(object->positions.data()), sizeof(float) * vertexCount * 3);
 
-					material->displacementMap.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP);
+					// Vertex Normals
+					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::NORMAL)) bomFile.write(reinterpret_cast<char*>(object->normals.data()), sizeof(float) * vertexCount * 3);
+
+					// Vertex UVs
+					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV)) bomFile.write(reinterpret_cast<char*>(object->uvs.data()), sizeof(float) * vertexCount * 2);
+					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::UV2)) bomFile.write(reinterpret_cast<char*>(object->uvs2.data()), sizeof(float) * vertexCount * 2);
+
+					// Vertex Tangents
+					if(geometryAttributes & BitmaskFlag(GeometryDataAttribute::TANGENT)) bomFile.write(reinterpret_cast<char*>(object->tangents.data()), sizeof(float) * vertexCount * 4);
 
 				}
-				else if(optionType == "-s")
+
+				// Object Bounds
+				if(objectAttributes & BitmaskFlag(ObjectDataAttribute::BOUNDS)) bomFile.write(reinterpret_cast<char*>(&object->bounds), sizeof(object->bounds));
+
+				// Group Count
+				if(!WriteCount<std::uint16_t>(bomFile, object->groups.size())) return overflow("Group count " + std::to_string(object->groups.size()) + " of an object in asset '" + asset->name + "'");
+
+				for(const auto &group : object->groups)
 				{
-					if(iss >> material->displacementMap.scale.x >> material->displacementMap.scale.y >> material->displacementMap.displacementScale)
-					{
-						material->displacementMap.attributes |= BitmaskFlag(MapDataAttribute::DISPLACEMENT_SCALE);
-						material->attributes |= BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP);
+					// Group Data Attributes
+					auto groupAttributes = BitmaskFlag(GroupDataAttribute::NONE);
+					if(!group->name.empty()) groupAttributes |= BitmaskFlag(GroupDataAttribute::NAME);
+					if(!group->faces.empty()) groupAttributes |= BitmaskFlag(GroupDataAttribute::INDEX);
+					if(group->smoothing >= 0) groupAttributes |= BitmaskFlag(GroupDataAttribute::SMOOTHING);
+					if(!group->materialName.empty() && materialIndices.find(group->materialId) != materialIndices.end()) groupAttributes |= BitmaskFlag(GroupDataAttribute::MATERIAL);
+					if(!group->faces.empty() && computeBounds) groupAttributes |= BitmaskFlag(GroupDataAttribute::BOUNDS);
+					bomFile.write(reinterpret_cast<char*>(&groupAttributes), sizeof(groupAttributes));
 
-					}
-					else if(!(iss >> material->displacementMap.scale.x >> material->displacementMap.scale.y))
+					// Group Name
+					if((groupAttributes & BitmaskFlag(GroupDataAttribute::NAME)) && !WriteString(bomFile, group->name, stringTable)) return overflow("Name length of group '" + group->name.substr(0, 64) + "'");
+
+					if(objectAttributes & BitmaskFlag(ObjectDataAttribute::GEOMETRY))
 					{
-						if(logWarnings) std::cout << "ERROR: [" << objState->materialFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						break;
+						// Indices
+						if(groupAttributes & BitmaskFlag(GroupDataAttribute::INDEX))
+						{
+							// Index Count
+							const std::size_t indexCount = group->faces.size() * 3;
+							if(!WriteCount<std::uint32_t>(bomFile, indexCount)) return overflow("Index count " + std::to_string(indexCount) + " of group '" + group->name + "'");
 
-					}
+							// Indices
+							std::vector<bom_index_t> indices;
+							indices.reserve(indexCount);
 
-					material->displacementMap.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP);
+							for(const auto &face : group->faces)
+							{
+								if(std::max({ face.a, face.b, face.c }) >= maxIndexableVertices)
+								{
+									if(logErrors) Log() << "ERROR: [" << bomFilePath << "] Group '" << group->name << "' in asset '" << asset->name << "' references a vertex beyond the " << maxIndexableVertices << " vertex limit of an object." << std::endl;
+									return false;
 
-				}
-				else
-				{
-					material->displacementMap.path = optionType;
-					material->displacementMap.attributes |= BitmaskFlag(MapDataAttribute::PATH);
-					material->attributes |= BitmaskFlag(MaterialDataAttribute::DISPLACEMENT_MAP);
-					break;
+								}
+
+								indices.push_back(static_cast<bom_index_t>(face.a));
+								indices.push_back(static_cast<bom_index_t>(face.b));
+								indices.push_back(static_cast<bom_index_t>(face.c));
+
+							}
+
+							bomFile.write(reinterpret_cast<char*>(indices.data()), sizeof(bom_index_t) * indexCount);
+
+						}
+
+						// Smoothing
+						if(groupAttributes & BitmaskFlag(GroupDataAttribute::SMOOTHING)) bomFile.write(reinterpret_cast<char*>(&group->smoothing), sizeof(group->smoothing));
+
+						if(groupAttributes & BitmaskFlag(GroupDataAttribute::MATERIAL))
+						{
+							// Material ID
+							if(!WriteCount<std::uint16_t>(bomFile, materialIndices[group->materialId])) return overflow("Material ID of group '" + group->name + "'");
+
+						}
+
+						// Group Bounds
+						if(groupAttributes & BitmaskFlag(GroupDataAttribute::BOUNDS)) bomFile.write(reinterpret_cast<char*>(&group->bounds), sizeof(group->bounds));
+
+					}
 
 				}
 
 			}
 
 		}
-		else
-		{
-			if(logWarnings) std::cout << "WARNING: [" << objState->materialFileName << ":" << lineNo << "]: Unsupported entry type '" << entryType << "'" << std::endl;
 
-		}
+	}
+
+	if(fileAttributes & BitmaskFlag(FileDataAttribute::BVH))
+	{
+		beginSection(BomSection::BVH);
+
+		// BVH Primitives
+		if(!WriteCount<std::uint32_t>(bomFile, bvh->primitives.size())) return overflow("BVH primitive count " + std::to_string(bvh->primitives.size()));
+		bomFile.write(reinterpret_cast<const char*>(bvh->primitives.data()), sizeof(bvh_primitive_t) * bvh->primitives.size());
+
+		// BVH Nodes
+		if(!WriteCount<std::uint32_t>(bomFile, bvh->nodes.size())) return overflow("BVH node count " + std::to_string(bvh->nodes.size()));
+		bomFile.write(reinterpret_cast<const char*>(bvh->nodes.data()), sizeof(bvh_node_t) * bvh->nodes.size());
 
 	}
 
-	mtlFile.close();
+	if(!bomFileBuffer.Close() || !bomFile) return false;
 
-	if(mtlState->materials.empty()) mtlState->materials.insert(std::make_pair(material->id, material));
+	if(fileAttributes & BitmaskFlag(FileDataAttribute::CONTENT_HASH)) return WriteContentHash(outputFilePath, sectionOffsets, bomFileBuffer.SectionHashes(), bomFileBuffer.FileHash(), digest);
 
+	digest = { bomFileBuffer.FileHash().Size(), bomFileBuffer.FileHash().Digest() };
 	return true;
 
 }
 
-// f position.a/uv.a/normal.a position.b/uv.b/normal.b position.c/uv.c/normal.c [position.d/uv.d/normal.d] [position.n/uv.n/normal.n]
-static const std::regex FACE_POSITION_UV_NORMAL { R"(^f\s+(-?\d+)\/(-?\d+)\/(-?\d+)\s+(-?\d+)\/(-?\d+)\/(-?\d+)\s+(-?\d+)\/(-?\d+)\/(-?\d+)(?:\s+(-?\d+)\/(-?\d+)\/(-?\d+))?(?:\s+(-?\d+)\/(-?\d+)\/(-?\d+))?)" };
+// The BOM is written to a temporary file that only replaces the output once complete, so that a failed conversion leaves neither a
+// truncated file nor a missing one where a previous conversion succeeded.  Gives the size and hash of the written file through digest.
+bool WriteBOM(const std::vector<std::shared_ptr<bom_asset_t>> &assets, const std::string &bomFilePath, const bom_bvh_t *bvh, bom_file_digest_t &digest)
+{
+	Log() << "Writing BOM '" << bomFilePath << "'..." << std::endl;
 
-// f position.a position.b position.c [position.d] [position.n]
-static const std::regex FACE_POSITION { R"(^f\s+(-?\d+)\s+(-?\d+)\s+(-?\d+)(?:\s+(-?\d+))?(?:\s+(-?\d+))?)" };
+	const std::string partialFilePath = bomFilePath + ".partial";
+	if(WriteBOMFile(assets, bomFilePath, partialFilePath, bvh, digest))
+	{
+		// Replacing the output in one step keeps the previous BOM in place should the replacement fail.
+#ifdef _WIN32
+		if(MoveFileExA(partialFilePath.c_str(), bomFilePath.c_str(), MOVEFILE_REPLACE_EXISTING)) return true;
+#else
+		if(std::rename(partialFilePath.c_str(), bomFilePath.c_str()) == 0) return true;
+#endif
 
-// f position.a/uv.a position.b/uv.b position.c/uv.c [position.d/uv.d] [position.n/uv.n]
-static const std::regex FACE_POSITION_UV { R"(^f\s+(-?\d+)\/(-?\d+)\s+(-?\d+)\/(-?\d+)\s+(-?\d+)\/(-?\d+)(?:\s+(-?\d+)\/(-?\d+))?(?:\s+(-?\d+)\/(-?\d+))?)" };
+	}
 
-// f position.a//normal.a position.b//normal.b position.c//normal.c [position.d//normal.d] [position.n//normal.n]
-static const std::regex FACE_POSITION_NORMAL { R"(^f\s+(-?\d+)\/\/(-?\d+)\s+(-?\d+)\/\/(-?\d+)\s+(-?\d+)\/\/(-?\d+)(?:\s+(-?\d+)\/\/(-?\d+))?(?:\s+(-?\d+)\/\/(-?\d+))?)" };
+	std::remove(partialFilePath.c_str());
+	return false;
 
-bool ReadOBJ(std::shared_ptr<bom_asset_t> asset, const std::string &objFilePath)
+}
+
+// Resolves a file path to an absolute path so that files referenced through different relative paths share cache entries.
+std::string ResolvePath(const std::string &filePath)
 {
-	std::ifstream objFile(objFilePath);
-	if(!objFile.is_open()) return false;
-	std::string line;
-	int lineNo = 0;
+#ifdef _WIN32
+	char resolvedPath[_MAX_PATH];
+	if(_fullpath(resolvedPath, filePath.c_str(), _MAX_PATH)) return resolvedPath;
+#else
+	char *resolvedPath = realpath(filePath.c_str(), nullptr);
+	if(resolvedPath)
+	{
+		std::string result = resolvedPath;
+		std::free(resolvedPath);
+		return result;
 
-	std::map<std::string, obj_index_t> indices;
-	std::vector<obj_vector3_t> positions, normals;
-	std::vector<obj_vector2_t> uvs, uvs2;
-	obj_index_t index = 0;
+	}
+#endif
 
-	bool isFirstObject = true, isFirstGroup = true;
-	std::string relativePath = objFilePath.substr(0, objFilePath.find_last_of("/\\") + 1);
-	std::shared_ptr<obj_object_t> object = std::make_shared<obj_object_t>();
-	auto group = std::make_shared<obj_group_t>();
+	return filePath;
 
-	auto objState = std::make_shared<obj_state_t>();
+}
 
-	std::cout << "Parsing OBJ '" << objFilePath << "'..." << std::endl;
-	while(std::getline(objFile, line))
+// Copies a parsed material library, optionally assigning new material IDs from the current conversion.
+std::shared_ptr<mtl_state_t> CloneMTL(const mtl_state_t &source, bool assignMaterialIds = true)
+{
+	auto mtlState = std::make_shared<mtl_state_t>();
+	mtlState->name = source.name;
+	mtlState->filePath = source.filePath;
+	mtlState->contentHash = source.contentHash;
+
+	for(const auto &material : source.materials)
 	{
-		++lineNo;
-		std::istringstream iss(line);
-		//std::cout << line << "\n";
-		if(line.empty()) continue;
+		auto clone = std::make_shared<mtl_material_t>(*material.second);
+		if(assignMaterialIds) clone->id = maxMaterialId++;
+		mtlState->materials.insert(std::make_pair(clone->id, clone));
+		mtlState->materialIds.insert(std::make_pair(clone->name, clone->id));
 
-		std::string entryType;
-		if(!(iss >> entryType))
+	}
+
+	return mtlState;
+
+}
+
+// MTL Tokenizer
+// Splits a line of an MTL file, or the arguments of an OBJ vertex record, held in memory in to whitespace separated tokens without copying it.
+struct mtl_token_t
+{
+	const char *data = nullptr;
+	std::size_t size = 0;
+
+	bool operator==(const char *other) const { return std::strlen(other) == size && std::memcmp(data, other, size) == 0; }
+	std::string str() const { return std::string(data, size); }
+
+};
+
+struct mtl_tokenizer_t
+{
+	const char *cursor, *end;
+
+	static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+	bool Next(mtl_token_t &token)
+	{
+		while(cursor != end && IsSpace(*cursor)) ++cursor;
+		if(cursor == end) return false;
+
+		token.data = cursor;
+		while(cursor != end && !IsSpace(*cursor)) ++cursor;
+		token.size = cursor - token.data;
+		return true;
+
+	}
+
+	// Fast path for plain decimals such as '-0.125', which make up nearly all MTL and OBJ values.  The digits are exact in the type dividing
+	// them and so is the power of ten, so the single division rounds correctly.  Floats are divided in single precision, as rounding a double
+	// quotient to a float again could be off by one unit in the last place.  Exponents, long mantissas and anything else fall back to strtof.
+	template <typename T>
+	static bool ParseDecimal(const mtl_token_t &token, T &value)
+	{
+		static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+		const char *p = token.data, *end = token.data + token.size;
+		bool negative = p != end && *p == '-';
+		if(p != end && (*p == '-' || *p == '+')) ++p;
+
+		std::uint64_t mantissa = 0;
+		int digits = 0, fractionDigits = 0;
+		bool fraction = false;
+
+		for(; p != end; ++p)
+		{
+			if(*p == '.' && !fraction) fraction = true;
+			else if(*p >= '0' && *p <= '9')
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if(fraction) ++fractionDigits;
+				if(++digits > 15) return false;
+
+			}
+			else return false;
+
+		}
+
+		if(digits == 0) return false;
+
+		if(std::is_same<T, float>::value)
 		{
-			if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Failed to parse entry type." << std::endl;
+			if(digits > 7) return false;
+
+			float result = static_cast<float>(mantissa) / static_cast<float>(POWERS_OF_TEN[fractionDigits]);
+			value = static_cast<T>(negative ? -result : result);
+			return true;
+
+		}
+
+		double result = static_cast<double>(mantissa) / POWERS_OF_TEN[fractionDigits];
+		value = static_cast<T>(negative ? -result : result);
+		return true;
+
+	}
+
+	// Reads a number, leaving the tokenizer untouched if the next token is not entirely numeric.
+	template <typename T>
+	bool NextNumber(T &value)
+	{
+		auto start = cursor;
+		mtl_token_t token;
+		if(!Next(token) || token.size >= 64)
+		{
+			cursor = start;
 			return false;
 
 		}
 
-		if(entryType == "mtllib")
+		if(std::is_floating_point<T>::value && ParseDecimal(token, value)) return true;
+
+		// Tokens are not null terminated, so they are copied to a small buffer for conversion.
+		char buffer[64];
+		std::memcpy(buffer, token.data, token.size);
+		buffer[token.size] = '\0';
+
+		char *parsedEnd = nullptr;
+		auto parsed = std::is_floating_point<T>::value ? static_cast<T>(std::strtof(buffer, &parsedEnd)) : static_cast<T>(std::strtol(buffer, &parsedEnd, 10));
+		if(parsedEnd != buffer + token.size)
 		{
-			if(!(iss >> objState->materialFileName))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+			cursor = start;
+			return false;
 
-			}
-			
-			objState->materialFileName = objState->materialFileName.substr(objState->materialFileName.find_last_of("/\\") + 1);
+		}
 
-			if(!ReadMTL(relativePath, objState))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Failed to open material file '" << objState->materialFileName << "'" << std::endl;
-				return false;
+		value = parsed;
+		return true;
 
-			}
+	}
+
+	// Reads a color as one value applied to all channels or as three values.
+	bool NextColor(mtl_color_t &color)
+	{
+		if(!NextNumber(color.r)) return false;
+		auto start = cursor;
+		if(!NextNumber(color.g) || !NextNumber(color.b))
+		{
+			cursor = start;
+			color.g = color.b = color.r;
+
+		}
+
+		return true;
+
+	}
+
+};
+
+enum class MtlEntry : std::uint8_t
+{
+	NEW_MATERIAL,
+	ILLUMINATION_MODEL,
+	SCALAR,
+	TRANSPARENCY,
+	COLOR,
+	MAP,
+	FACE_CULLING
+
+};
+
+// MTL Keywords
+// Each entry type is described by the material property it writes, so that properties of the same kind share a single parsing path.
+struct mtl_keyword_t
+{
+	const char *name;
+	std::size_t length;
+	MtlEntry entry;
+	MaterialDataAttribute attribute;
+	float mtl_material_t::*scalar;
+	mtl_color_t mtl_material_t::*color;
+	mtl_map_t mtl_material_t::*map;
+
+};
+
+static const mtl_keyword_t MTL_KEYWORDS[] =
+{
+	{ "newmtl", 6, MtlEntry::NEW_MATERIAL, MaterialDataAttribute::NONE, nullptr, nullptr, nullptr },
+	{ "illum", 5, MtlEntry::ILLUMINATION_MODEL, MaterialDataAttribute::ILLUMINATION_MODEL, nullptr, nullptr, nullptr },
+	{ "Ns", 2, MtlEntry::SCALAR, MaterialDataAttribute::SPECULAR_EXPONENT, &mtl_material_t::specularExponent, nullptr, nullptr },
+	{ "Ni", 2, MtlEntry::SCALAR, MaterialDataAttribute::OPTICAL_DENSITY, &mtl_material_t::opticalDensity, nullptr, nullptr },
+	{ "d", 1, MtlEntry::SCALAR, MaterialDataAttribute::DISSOLVE, &mtl_material_t::dissolve, nullptr, nullptr },
+	{ "Tr", 2, MtlEntry::TRANSPARENCY, MaterialDataAttribute::DISSOLVE, &mtl_material_t::dissolve, nullptr, nullptr },
+	{ "Tf", 2, MtlEntry::COLOR, MaterialDataAttribute::TRANSMISSION_FILTER, nullptr, &mtl_material_t::transmissionFilter, nullptr },
+	{ "Ka", 2, MtlEntry::COLOR, MaterialDataAttribute::AMBIENT_REFLECTANCE, nullptr, &mtl_material_t::ambientReflectance, nullptr },
+	{ "Kd", 2, MtlEntry::COLOR, MaterialDataAttribute::DIFFUSE_REFLECTANCE, nullptr, &mtl_material_t::diffuseReflectance, nullptr },
+	{ "Ks", 2, MtlEntry::COLOR, MaterialDataAttribute::SPECULAR_REFLECTANCE, nullptr, &mtl_material_t::specularReflectance, nullptr },
+	{ "Ke", 2, MtlEntry::COLOR, MaterialDataAttribute::EMISSIVE_REFLECTANCE, nullptr, &mtl_material_t::emissiveReflectance, nullptr },
+	{ "map_Ka", 6, MtlEntry::MAP, MaterialDataAttribute::AMBIENT_MAP, nullptr, nullptr, &mtl_material_t::ambientMap },
+	{ "map_Kd", 6, MtlEntry::MAP, MaterialDataAttribute::DIFFUSE_MAP, nullptr, nullptr, &mtl_material_t::diffuseMap },
+	{ "map_Ks", 6, MtlEntry::MAP, MaterialDataAttribute::SPECULAR_MAP, nullptr, nullptr, &mtl_material_t::specularMap },
+	{ "map_Ke", 6, MtlEntry::MAP, MaterialDataAttribute::EMISSIVE_MAP, nullptr, nullptr, &mtl_material_t::emissiveMap },
+	{ "map_d", 5, MtlEntry::MAP, MaterialDataAttribute::DISSOLVE_MAP, nullptr, nullptr, &mtl_material_t::dissolveMap },
+	{ "map_bump", 8, MtlEntry::MAP, MaterialDataAttribute::BUMP_MAP, nullptr, nullptr, &mtl_material_t::bumpMap },
+	{ "bump", 4, MtlEntry::MAP, MaterialDataAttribute::BUMP_MAP, nullptr, nullptr, &mtl_material_t::bumpMap },
+	{ "map_disp", 8, MtlEntry::MAP, MaterialDataAttribute::DISPLACEMENT_MAP, nullptr, nullptr, &mtl_material_t::displacementMap },
+	{ "disp", 4, MtlEntry::MAP, MaterialDataAttribute::DISPLACEMENT_MAP, nullptr, nullptr, &mtl_material_t::displacementMap },
+	{ "Pr", 2, MtlEntry::SCALAR, MaterialDataAttribute::ROUGHNESS, &mtl_material_t::roughness, nullptr, nullptr },
+	{ "Pm", 2, MtlEntry::SCALAR, MaterialDataAttribute::METALLIC, &mtl_material_t::metallic, nullptr, nullptr },
+	{ "Ps", 2, MtlEntry::SCALAR, MaterialDataAttribute::SHEEN, &mtl_material_t::sheen, nullptr, nullptr },
+	{ "Pc", 2, MtlEntry::SCALAR, MaterialDataAttribute::CLEARCOAT_THICKNESS, &mtl_material_t::clearcoatThickness, nullptr, nullptr },
+	{ "Pcr", 3, MtlEntry::SCALAR, MaterialDataAttribute::CLEARCOAT_ROUGHNESS, &mtl_material_t::clearcoatRoughness, nullptr, nullptr },
+	{ "aniso", 5, MtlEntry::SCALAR, MaterialDataAttribute::ANISOTROPY, &mtl_material_t::anisotropy, nullptr, nullptr },
+	{ "anisor", 6, MtlEntry::SCALAR, MaterialDataAttribute::ANISOTROPY_ROTATION, &mtl_material_t::anisotropyRotation, nullptr, nullptr },
+	{ "map_Pr", 6, MtlEntry::MAP, MaterialDataAttribute::ROUGHNESS_MAP, nullptr, nullptr, &mtl_material_t::roughnessMap },
+	{ "map_Pm", 6, MtlEntry::MAP, MaterialDataAttribute::METALLIC_MAP, nullptr, nullptr, &mtl_material_t::metallicMap },
+	{ "map_Ps", 6, MtlEntry::MAP, MaterialDataAttribute::SHEEN_MAP, nullptr, nullptr, &mtl_material_t::sheenMap },
+	{ "norm", 4, MtlEntry::MAP, MaterialDataAttribute::NORMAL_MAP, nullptr, nullptr, &mtl_material_t::normalMap }
+
+};
+
+// Vendor-specific entry types, following '# :BOM:'
+static const mtl_keyword_t MTL_VENDOR_KEYWORDS[] =
+{
+	{ "cull_face", 9, MtlEntry::FACE_CULLING, MaterialDataAttribute::FACE_CULLING, nullptr, nullptr, nullptr },
+	{ "lightmap", 8, MtlEntry::MAP, MaterialDataAttribute::LIGHT_MAP, nullptr, nullptr, &mtl_material_t::lightMap }
+
+};
+
+// MTL Keyword Table
+// Entry types are found by hashing the token in to an open-addressed table built once from a keyword list, so that a line costs one hash
+// and nearly always a single comparison rather than a scan over every keyword.
+class MtlKeywordTable
+{
+public:
+	template <std::size_t N>
+	explicit MtlKeywordTable(const mtl_keyword_t (&keywords)[N])
+	{
+		static_assert(N <= SLOT_COUNT / 2, "MTL keyword table is too small for the keyword list");
+
+		std::fill(std::begin(slots), std::end(slots), nullptr);
+		for(const auto &keyword : keywords)
+		{
+			auto slot = Hash(keyword.name, keyword.length);
+			while(slots[slot]) slot = (slot + 1) % SLOT_COUNT;
+			slots[slot] = &keyword;
+
+		}
+
+	}
+
+	const mtl_keyword_t *Find(const mtl_token_t &token) const
+	{
+		for(auto slot = Hash(token.data, token.size); slots[slot]; slot = (slot + 1) % SLOT_COUNT)
+		{
+			const auto *keyword = slots[slot];
+			if(keyword->length == token.size && std::memcmp(keyword->name, token.data, token.size) == 0) return keyword;
+
+		}
+
+		return nullptr;
+
+	}
+
+private:
+	static const std::size_t SLOT_COUNT = 64;
+
+	// Hashes the first and last bytes and the length of a keyword, which the multipliers spread over the table such that only two of the
+	// standard keywords share a slot with another.
+	static std::size_t Hash(const char *data, std::size_t size)
+	{
+		return (static_cast<unsigned char>(data[0]) * 2u + static_cast<unsigned char>(data[size - 1]) * 41u + size * 18u) % SLOT_COUNT;
+
+	}
+
+	const mtl_keyword_t *slots[SLOT_COUNT];
+
+};
+
+static const MtlKeywordTable MTL_KEYWORD_TABLE(MTL_KEYWORDS), MTL_VENDOR_KEYWORD_TABLE(MTL_VENDOR_KEYWORDS);
+
+// Map Options
+// [-blendu on|off] [-blendv on|off] [-boost <value>] [-mm <base> <gain>] [-o <u> [v] [w]] [-s <u> [v] [w]] [-t <u> [v] [w]] [-texres <resolution>]
+// [-clamp on|off] [-bm <multiplier>] [-imfchan r|g|b|m|l|z] [-type <sphere|cube_top|cube_bottom|cube_front|cube_back|cube_left|cube_right>]
+// [-cc on|off] [-intensity <intensity_modifier>] <path>
+// Offsets and scales keep their u and v components, except that the third scale value of a displacement map holds its displacement scale.
+bool ReadMapOptions(mtl_tokenizer_t &tokens, mtl_map_t &map, bool isDisplacementMap)
+{
+	// Reads one of the given names, returning its position in the list.
+	auto readChoice = [&tokens](std::initializer_list<const char*> choices, std::size_t &choice)
+	{
+		mtl_token_t value;
+		if(!tokens.Next(value)) return false;
+
+		choice = 0;
+		for(const auto *name : choices)
+		{
+			if(value == name) return true;
+			++choice;
+
+		}
+
+		return false;
+
+	};
+
+	// Options which are not given take their defaults once any of them is, blending enabled while clamping and color correction are not.
+	auto readOption = [&](MapOption option)
+	{
+		std::size_t enabled;
+		if(!readChoice({ "off", "on" }, enabled)) return false;
+
+		if(!(map.attributes & BitmaskFlag(MapDataAttribute::OPTIONS))) map.options = BitmaskFlag(MapOption::BLEND_U) | BitmaskFlag(MapOption::BLEND_V);
+		if(enabled) map.options |= BitmaskFlag(option);
+		else map.options &= ~BitmaskFlag(option);
+
+		map.attributes |= BitmaskFlag(MapDataAttribute::OPTIONS);
+		return true;
+
+	};
+
+	mtl_token_t option;
+	while(tokens.Next(option))
+	{
+		if(option == "-o")
+		{
+			if(!tokens.NextNumber(map.offset.x)) return false;
+
+			float w;
+			map.offset.y = 0.0f;
+			if(tokens.NextNumber(map.offset.y)) tokens.NextNumber(w);
+			map.attributes |= BitmaskFlag(MapDataAttribute::OFFSET);
+
+		}
+		else if(option == "-s")
+		{
+			if(!tokens.NextNumber(map.scale.x)) return false;
+
+			float w;
+			map.scale.y = 1.0f;
+			if(tokens.NextNumber(map.scale.y) && tokens.NextNumber(w) && isDisplacementMap)
+			{
+				map.displacementScale = w;
+				map.attributes |= BitmaskFlag(MapDataAttribute::DISPLACEMENT_SCALE);
+
+			}
+
+			map.attributes |= BitmaskFlag(MapDataAttribute::SCALE);
+
+		}
+		else if(option == "-t")
+		{
+			if(!tokens.NextNumber(map.turbulence.x)) return false;
+
+			map.turbulence.y = map.turbulence.z = 0.0f;
+			if(tokens.NextNumber(map.turbulence.y)) tokens.NextNumber(map.turbulence.z);
+			map.attributes |= BitmaskFlag(MapDataAttribute::TURBULENCE);
+
+		}
+		else if(option == "-bm")
+		{
+			if(!tokens.NextNumber(map.bumpScale)) return false;
+			map.attributes |= BitmaskFlag(MapDataAttribute::BUMP_SCALE);
+
+		}
+		else if(option == "-intensity")
+		{
+			if(!tokens.NextNumber(map.lightmapIntensity)) return false;
+			map.attributes |= BitmaskFlag(MapDataAttribute::LIGHTMAP_INTENSITY);
+
+		}
+		else if(option == "-boost")
+		{
+			if(!tokens.NextNumber(map.boost)) return false;
+			map.attributes |= BitmaskFlag(MapDataAttribute::BOOST);
+
+		}
+		else if(option == "-mm")
+		{
+			if(!tokens.NextNumber(map.range.x) || !tokens.NextNumber(map.range.y)) return false;
+			map.attributes |= BitmaskFlag(MapDataAttribute::RANGE);
+
+		}
+		else if(option == "-texres")
+		{
+			std::int64_t resolution;
+			if(!tokens.NextNumber(resolution) || resolution <= 0 || resolution > std::numeric_limits<std::uint32_t>::max()) return false;
+
+			map.resolution = static_cast<std::uint32_t>(resolution);
+			map.attributes |= BitmaskFlag(MapDataAttribute::RESOLUTION);
+
+		}
+		else if(option == "-imfchan")
+		{
+			std::size_t channel;
+			if(!readChoice({ "r", "g", "b", "m", "l", "z" }, channel)) return false;
+
+			map.channel = static_cast<MapChannel>(channel);
+			map.attributes |= BitmaskFlag(MapDataAttribute::CHANNEL);
+
+		}
+		else if(option == "-type")
+		{
+			std::size_t projection;
+			if(!readChoice({ "sphere", "cube_top", "cube_bottom", "cube_front", "cube_back", "cube_left", "cube_right" }, projection)) return false;
+
+			map.projection = static_cast<MapProjection>(projection);
+			map.attributes |= BitmaskFlag(MapDataAttribute::PROJECTION);
+
+		}
+		else if(option == "-blendu")
+		{
+			if(!readOption(MapOption::BLEND_U)) return false;
+
+		}
+		else if(option == "-blendv")
+		{
+			if(!readOption(MapOption::BLEND_V)) return false;
+
+		}
+		else if(option == "-clamp")
+		{
+			if(!readOption(MapOption::CLAMP)) return false;
+
+		}
+		else if(option == "-cc")
+		{
+			if(!readOption(MapOption::COLOR_CORRECTION)) return false;
+
+		}
+		else
+		{
+			map.path = option.str();
+			map.attributes |= BitmaskFlag(MapDataAttribute::PATH);
+			break;
+
+		}
+
+	}
+
+	return true;
+
+}
+
+// Parses a material library held in memory, adding its materials to the given state.
+void ParseMTL(const std::string &content, mtl_state_t &mtlState)
+{
+	const auto &mtlFileName = mtlState.name;
+
+	std::shared_ptr<mtl_material_t> material = std::make_shared<mtl_material_t>();
+	material->id = maxMaterialId++;
+
+	const char *line = content.data(), *contentEnd = content.data() + content.size();
+	int lineNo = 0;
+
+	while(line < contentEnd)
+	{
+		++lineNo;
+		const char *lineEnd = static_cast<const char*>(std::memchr(line, '\n', contentEnd - line));
+		if(!lineEnd) lineEnd = contentEnd;
+
+		mtl_tokenizer_t tokens { line, lineEnd };
+		line = lineEnd + 1;
+
+		mtl_token_t entryType;
+		if(!tokens.Next(entryType)) continue;
+
+		const mtl_keyword_t *keyword = nullptr;
+		bool isVendorEntry = false;
+
+		if(entryType.data[0] == '#')
+		{
+			// Attempt to parse out vendor-specific material property
+			// # :<vendor>: <property> [value0] [value1] [valueN...]
+			mtl_token_t vendor;
+			if(!(entryType == "#") || !tokens.Next(vendor) || !(vendor == ":BOM:")) continue;
+
+			if(!tokens.Next(entryType))
+			{
+				if(logWarnings) Log() << "WARNING: [" << mtlFileName << ":" << lineNo << "] Vendor-specific material entry type could not be parsed and will be skipped." << std::endl;
+				continue;
+
+			}
+
+			keyword = MTL_VENDOR_KEYWORD_TABLE.Find(entryType);
+			if(!keyword) continue;
+			isVendorEntry = true;
+
+		}
+		else
+		{
+			keyword = MTL_KEYWORD_TABLE.Find(entryType);
+			if(!keyword)
+			{
+				if(logWarnings) Log() << "WARNING: [" << mtlFileName << ":" << lineNo << "]: Unsupported entry type '" << entryType.str() << "'" << std::endl;
+				continue;
+
+			}
+
+		}
+
+		bool parsed = true;
+
+		switch(keyword->entry)
+		{
+			case MtlEntry::NEW_MATERIAL:
+			{
+				if(!mtlState.materials.empty())
+				{
+					material = std::make_shared<mtl_material_t>();
+					material->id = maxMaterialId++;
+
+				}
+
+				mtl_token_t name;
+				parsed = tokens.Next(name);
+				if(!parsed) break;
+
+				material->name = name.str();
+				mtlState.materials.insert(std::make_pair(material->id, material));
+				mtlState.materialIds.insert(std::make_pair(material->name, material->id));
+				break;
+
+			}
+
+			case MtlEntry::ILLUMINATION_MODEL:
+			{
+				int illuminationModel;
+				parsed = tokens.NextNumber(illuminationModel) && illuminationModel >= 0 && illuminationModel <= std::numeric_limits<std::uint8_t>::max();
+				if(parsed) material->illuminationModel = static_cast<std::uint8_t>(illuminationModel);
+				break;
+
+			}
+
+			case MtlEntry::SCALAR:
+			{
+				// d [-halo] <factor>
+				auto start = tokens.cursor;
+				mtl_token_t halo;
+				if(!tokens.Next(halo) || !(halo == "-halo")) tokens.cursor = start;
+
+				parsed = tokens.NextNumber(material.get()->*keyword->scalar);
+				break;
+
+			}
+
+			case MtlEntry::TRANSPARENCY:
+			{
+				// Tr <transparency>, the inverse of d which takes precedence
+				if(material->attributes & BitmaskFlag(keyword->attribute))
+				{
+					if(logWarnings) Log() << "WARNING: [" << mtlFileName << ":" << lineNo << "] Transparency (Tr) property is non-standard, defaulting to Dissolve (d)." << std::endl;
+					continue;
+
+				}
+
+				float transparency;
+				parsed = tokens.NextNumber(transparency);
+				if(parsed) material.get()->*keyword->scalar = 1.0f - transparency;
+				break;
+
+			}
+
+			case MtlEntry::COLOR:
+			{
+				parsed = tokens.NextColor(material.get()->*keyword->color);
+				break;
+
+			}
+
+			case MtlEntry::MAP:
+			{
+				// A malformed option only ends the map entry, keeping the options read before it, rather than the rest of the library.
+				auto &map = material.get()->*keyword->map;
+				if(!ReadMapOptions(tokens, map, keyword->map == &mtl_material_t::displacementMap))
+				{
+					if(logErrors) Log() << "ERROR: [" << mtlFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType.str() << "'" << std::endl;
+
+				}
+
+				if(map.attributes == 0) continue;
+				break;
+
+			}
+
+			case MtlEntry::FACE_CULLING:
+			{
+				// :BOM: cull_face <none|front|back|all>
+				// none (0x00): No face culling is applied.
+				// front (0x01): Front faces are culled.
+				// back (0x02): Back faces are culled.
+				// all (0x03): Both front and back faces are culled.
+				mtl_token_t faceCulling;
+				parsed = tokens.Next(faceCulling);
+				if(!parsed) break;
+
+				if(faceCulling == "none") material->faceCulling = FaceCulling::NONE;
+				else if(faceCulling == "front") material->faceCulling = FaceCulling::FRONT;
+				else if(faceCulling == "back") material->faceCulling = FaceCulling::BACK;
+				else if(faceCulling == "all") material->faceCulling = FaceCulling::ALL;
+				else
+				{
+					if(logWarnings) Log() << "WARNING: [" << mtlFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType.str() << "' has unsupported value will be skipped." << std::endl;
+					continue;
+
+				}
+
+				break;
+
+			}
+
+		}
+
+		if(!parsed)
+		{
+			if(isVendorEntry)
+			{
+				if(logWarnings) Log() << "WARNING: [" << mtlFileName << ":" << lineNo << "] Vendor-specific entry type '" << entryType.str() << "' could not be parsed and will be skipped." << std::endl;
+				continue;
+
+			}
+
+			if(logErrors) Log() << "ERROR: [" << mtlFileName << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType.str() << "'" << std::endl;
+			break;
+
+		}
+
+		if(keyword->attribute != MaterialDataAttribute::NONE) material->attributes |= BitmaskFlag(keyword->attribute);
+
+	}
+
+	if(mtlState.materials.empty())
+	{
+		mtlState.materials.insert(std::make_pair(material->id, material));
+		mtlState.materialIds.insert(std::make_pair(material->name, material->id));
+
+	}
+
+}
+
+bool ReadMTL(const std::string &relativePath, std::shared_ptr<obj_state_t> objState)
+{
+	const auto mtlFilePath = ResolvePath(relativePath + objState->materialFileName);
+
+	std::string content;
+	if(!ReadFile(mtlFilePath, content)) return false;
+
+	const auto contentHash = HashXXH64(content.data(), content.size());
+
+	// Share A Material Library Already Used By This Conversion
+	for(const auto &mtlState : mtlStates)
+	{
+		if(mtlState->filePath == mtlFilePath && mtlState->contentHash == contentHash)
+		{
+			objState->mtlState = mtlState;
+
+			Log() << "Sharing MTL '" << objState->materialFileName << "'..." << std::endl;
+			return true;
+
+		}
+
+	}
+
+	{
+		// Reuse A Material Library Parsed By Another Conversion
+		std::lock_guard<std::mutex> lock(mtlCacheMutex);
+		auto cachedState = mtlCache.find(mtlFilePath);
+		if(cachedState != mtlCache.end() && cachedState->second->contentHash == contentHash)
+		{
+			auto mtlState = CloneMTL(*cachedState->second);
+			mtlStates.push_back(mtlState);
+			objState->mtlState = mtlState;
+
+			Log() << "Reusing MTL '" << objState->materialFileName << "'..." << std::endl;
+			return true;
+
+		}
+
+	}
+
+	auto mtlState = std::make_shared<mtl_state_t>();
+	mtlStates.push_back(mtlState);
+	objState->mtlState = mtlState;
+
+	mtlState->name = objState->materialFileName;
+	mtlState->filePath = mtlFilePath;
+	mtlState->contentHash = contentHash;
+
+	Log() << "Parsing MTL '" << objState->materialFileName << "'..." << std::endl;
+	ParseMTL(content, *mtlState);
+
+	{
+		std::lock_guard<std::mutex> lock(mtlCacheMutex);
+		mtlCache[mtlFilePath] = CloneMTL(*mtlState, false);
+
+	}
+
+	return true;
+
+}
+
+// OBJ Vertex Records
+// The arguments of v, vn, vt and vt2 records are kept as text and only parsed in to floats when a face references them, so that records no
+// face references are never converted.  Records of streams dropped with --no-normals, --no-uv or --no-uv2 are not kept at all.
+bool ParseVertexRecord(mtl_tokenizer_t &tokens, obj_vector3_t &value) { return tokens.NextNumber(value.x) && tokens.NextNumber(value.y) && tokens.NextNumber(value.z); }
+bool ParseVertexRecord(mtl_tokenizer_t &tokens, obj_vector2_t &value) { return tokens.NextNumber(value.x) && tokens.NextNumber(value.y); }
+
+template <typename T>
+struct obj_vertex_records_t
+{
+	std::string text;
+	std::vector<std::size_t> ends;
+
+	void Add(const char *begin, const char *end)
+	{
+		text.append(begin, end);
+		ends.push_back(text.size());
+
+	}
+
+	std::size_t size() const { return ends.size(); }
+
+	// Resolves a one-based or negative OBJ index to a record number, where negative indices count back from the last of the first count records.
+	static bool Resolve(int index, std::size_t count, std::size_t &record)
+	{
+		record = index > 0 ? std::size_t(index - 1) : count - std::size_t(-std::int64_t(index));
+		return index != 0 && record < count;
+
+	}
+
+	mtl_tokenizer_t Tokens(std::size_t record) const { return { text.data() + (record > 0 ? ends[record - 1] : 0), text.data() + ends[record] }; }
+
+	bool Get(std::size_t record, T &value) const
+	{
+		auto tokens = Tokens(record);
+		return ParseVertexRecord(tokens, value);
+
+	}
+
+};
+
+// Face Corners
+// Faces are recorded while parsing as the records their corners resolve to, and only triangulated and indexed in to the vertex streams of
+// their object once the whole file has been read, see ReadOBJ.
+const std::uint32_t noStream = std::numeric_limits<std::uint32_t>::max(); // The stream had no records when the face was read, so its vertices receive zeros, or have none if no vertex of the object has any
+const std::uint32_t noRecord = noStream - 1; // The corner gives no index for the stream, or no vt2 record matches its vt index, so its vertices receive zeros
+
+struct obj_corner_t
+{
+	std::uint32_t position, normal, uv, uv2;
+
+	bool operator==(const obj_corner_t &other) const { return position == other.position && normal == other.normal && uv == other.uv && uv2 == other.uv2; }
+
+};
+
+struct obj_corner_hash_t
+{
+	std::size_t operator()(const obj_corner_t &corner) const { return static_cast<std::size_t>(HashXXH64(&corner, sizeof(corner))); }
+
+};
+
+struct obj_face_t
+{
+	int lineNo;
+	std::uint32_t cornerCount;
+
+};
+
+// Faces of one object waiting to be built, with their corners stored consecutively.
+struct obj_object_faces_t
+{
+	std::shared_ptr<obj_object_t> object;
+	std::shared_ptr<obj_group_t> group;
+	std::vector<obj_face_t> faces;
+	std::vector<obj_corner_t> corners;
+	int malformedLineNo = 0; // Line of the first face referencing a vertex record that could not be parsed
+	std::size_t unmatchedUV2s = 0;
+
+};
+
+// Face Syntax
+// f position.a position.b position.c [position.d] [position.n]
+// f position.a/uv.a position.b/uv.b position.c/uv.c [position.d/uv.d] [position.n/uv.n]
+// f position.a//normal.a position.b//normal.b position.c//normal.c [position.d//normal.d] [position.n//normal.n]
+// f position.a/uv.a/normal.a position.b/uv.b/normal.b position.c/uv.c/normal.c [position.d/uv.d/normal.d] [position.n/uv.n/normal.n]
+// Every corner takes the form of the first and anything following the corners is ignored.  Reads up to five corners, enough to recognise an
+// N-gon, leaving indices the form omits at zero.  Returns the number of corners read, or zero unless at least three were.
+int ParseFace(const std::string &line, int (&positions)[5], int (&uvs)[5], int (&normals)[5])
+{
+	const char *cursor = line.data(), *end = line.data() + line.size();
+
+	auto skipSpace = [&]()
+	{
+		const char *start = cursor;
+		while(cursor != end && mtl_tokenizer_t::IsSpace(*cursor)) ++cursor;
+		return cursor != start;
+
+	};
+
+	auto expect = [&](char c)
+	{
+		if(cursor == end || *cursor != c) return false;
+		++cursor;
+		return true;
+
+	};
+
+	// Indices beyond the range of an int are clamped, so that they fail to resolve to a record.
+	auto readIndex = [&](int &value)
+	{
+		const char *start = cursor;
+		bool negative = expect('-');
+		const char *digits = cursor;
+		std::int64_t magnitude = 0;
+		for(; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor) magnitude = std::min<std::int64_t>(magnitude * 10 + (*cursor - '0'), std::numeric_limits<int>::max());
+
+		if(cursor == digits)
+		{
+			cursor = start;
+			return false;
+
+		}
+
+		value = static_cast<int>(negative ? -magnitude : magnitude);
+		return true;
+
+	};
+
+	if(!expect('f') || !skipSpace()) return 0;
+
+	// Form Of The First Corner
+	bool hasUV = false, hasNormal = false;
+	const char *first = cursor;
+	int index;
+	if(!readIndex(index)) return 0;
+	if(expect('/'))
+	{
+		hasUV = readIndex(index);
+		hasNormal = expect('/');
+
+	}
+
+	cursor = first;
+
+	auto readCorner = [&](int corner)
+	{
+		if(!readIndex(positions[corner])) return false;
+		if(!hasUV && !hasNormal) return true;
+		if(!expect('/') || (hasUV && !readIndex(uvs[corner]))) return false;
+		return !hasNormal || (expect('/') && readIndex(normals[corner]));
+
+	};
+
+	int corners = 0;
+	for(; corners < 5; ++corners)
+	{
+		if((corners > 0 && !skipSpace()) || !readCorner(corners)) break;
+
+	}
+
+	return corners >= 3 ? corners : 0;
+
+}
+
+// Incremental Conversion
+// A section of an OBJ file runs from one 'o' or 'g' entry to the next and becomes one object, or several once split.  With --incremental every
+// section is fingerprinted while it is read, and the fingerprints are stored next to the BOM with the number of objects each section became,
+// see WriteSections.  A rerun then takes the objects of unchanged sections from the previous BOM instead of indexing and processing them again.
+struct bom_previous_section_t
+{
+	std::size_t firstObject, objectCount; // Objects of the previous BOM, numbered in file order across all assets
+
+};
+
+struct bom_previous_t
+{
+	std::string content;
+	BomReader reader;
+	std::vector<const BomReader::object_t*> objects;
+	std::map<std::string, std::unordered_map<std::uint64_t, bom_previous_section_t>> assets; // Sections by fingerprint, keyed by OBJ file path
+
+};
+
+// Number of records of each stream read up to a point of an OBJ file.
+struct obj_record_counts_t
+{
+	std::size_t positions, normals, uvs, uvs2;
+
+};
+
+// Rebuilds an object of a previous conversion.  All of its groups come from the single group of its section, so their name, material and
+// smoothing are taken from that group as read this time, which keeps material IDs consistent with the libraries of this conversion.
+void RestoreObject(const BomReader::object_t &source, const obj_group_t &sectionGroup, obj_object_t &object)
+{
+	auto copyStream = [](const BomReader::span_t<float> &span, auto &target)
+	{
+		target.resize(span.bytes() / sizeof(*target.data()));
+		if(!target.empty()) std::memcpy(target.data(), span.data, target.size() * sizeof(*target.data()));
+
+	};
+
+	copyStream(source.positions, object.positions);
+	copyStream(source.normals, object.normals);
+	copyStream(source.uvs, object.uvs);
+	copyStream(source.uvs2, object.uvs2);
+	copyStream(source.tangents, object.tangents);
+
+	object.groups.clear();
+	for(const auto &sourceGroup : source.groups)
+	{
+		auto group = std::make_shared<obj_group_t>();
+		group->materialId = sectionGroup.materialId;
+		group->name = sectionGroup.name;
+		group->materialName = sectionGroup.materialName;
+		group->smoothing = sectionGroup.smoothing;
+
+		group->faces.reserve(sourceGroup.indices.size / 3);
+		for(std::size_t i = 0; i + 2 < sourceGroup.indices.size; i += 3) group->faces.push_back({ sourceGroup.indices[i], sourceGroup.indices[i + 1], sourceGroup.indices[i + 2] });
+		object.groups.push_back(group);
+
+	}
+
+	object.reused = true;
+
+}
+
+bool ReadOBJ(std::shared_ptr<bom_asset_t> asset, const std::string &objFilePath, const bom_previous_t *previous = nullptr)
+{
+	static const std::size_t PARALLEL_CORNERS = 65536;
+
+	AsyncReadBuffer objFileBuffer;
+	if(!objFileBuffer.Open(objFilePath)) return false;
+	std::istream objFile(&objFileBuffer);
+	std::string line;
+	int lineNo = 0;
+
+	obj_vertex_records_t<obj_vector3_t> positions, normals;
+	obj_vertex_records_t<obj_vector2_t> uvs, uvs2;
+	std::size_t unmatchedUV2s = 0;
+
+	bool isFirstObject = true, isFirstGroup = true;
+	std::string relativePath = objFilePath.substr(0, objFilePath.find_last_of("/\\") + 1);
+	std::shared_ptr<obj_object_t> object = std::make_shared<obj_object_t>();
+	auto group = std::make_shared<obj_group_t>();
+
+	std::vector<obj_object_faces_t> objectFaces(1);
+	objectFaces.back().object = object;
+	objectFaces.back().group = group;
+
+	auto objState = std::make_shared<obj_state_t>();
+	const mtl_state_t *usedMtlState = nullptr; // Library the current material name was resolved against
+
+	// Texture coordinate records are kept without parsing, apart from a W component, which is only checked to warn that it is discarded.
+	auto addUVRecord = [&](obj_vertex_records_t<obj_vector2_t> &records, mtl_tokenizer_t tokens)
+	{
+		const char *begin = tokens.cursor;
+		mtl_token_t u, v;
+		float w;
+		if(tokens.Next(u) && tokens.Next(v) && tokens.NextNumber(w) && w > 0.0f)
+		{
+			if(logWarnings) Log() << "WARNING: [" << objFilePath << ":" << lineNo << "] 3D texture coordinates are not supported, W component has been discarded." << std::endl;
+
+		}
+
+		records.Add(begin, tokens.end);
+
+	};
+
+	// Resolves the indices of a corner against the records read so far, where normal and UV indices may be omitted.  A vt2 record pairs with
+	// the vt index of the corner, and a corner without a matching one has its second UV channel zeroed rather than failing.
+	auto resolveCorner = [&](int positionIndex, int normalIndex, int uvIndex, obj_corner_t &corner)
+	{
+		auto resolve = [](const auto &records, int index, bool isOptional, std::uint32_t &record)
+		{
+			std::size_t resolved;
+			if(records.size() == 0) record = noStream;
+			else if(isOptional && index == 0) record = noRecord;
+			else if(records.Resolve(index, records.size(), resolved)) record = static_cast<std::uint32_t>(resolved);
+			else return false;
+
+			return true;
+
+		};
+
+		if(!resolve(uvs2, uvIndex, false, corner.uv2)) corner.uv2 = noRecord;
+		return resolve(positions, positionIndex, false, corner.position) && resolve(normals, normalIndex, true, corner.normal) && resolve(uvs, uvIndex, true, corner.uv);
+
+	};
+
+	// Object Building
+	// Triangulates the faces of an object in to a flat array holding the corner of every vertex, then gathers its vertex streams from that array
+	// one stream at a time.  Unless geometry is not indexed, corners resolving to the same records share one vertex, found through an open
+	// addressing table of vertex numbers.  Every stream with records is written for every vertex, so corners without a normal, UV or vt2 record
+	// receive zeros.  Building only reads the vertex records, so the objects of a file are built concurrently once it has been read.
+	auto buildObject = [&](obj_object_faces_t &faces)
+	{
+		static const obj_index_t EMPTY_SLOT = std::numeric_limits<obj_index_t>::max();
+
+		auto &object = *faces.object;
+		auto &triangles = faces.group->faces;
+		std::vector<obj_corner_t> vertices; // Corner of every vertex, in order of first use
+
+		std::size_t triangleCount = 0;
+		for(const auto &face : faces.faces) triangleCount += face.cornerCount - 2;
+
+		// Triangulation
+		// Quads are split along the diagonal from their first corner.
+		auto triangulate = [&](auto addTriangle)
+		{
+			const obj_corner_t *corners = faces.corners.data();
+			for(const auto &face : faces.faces)
+			{
+				for(std::uint32_t corner = 2; corner < face.cornerCount; ++corner) addTriangle(corners[0], corners[corner - 1], corners[corner]);
+				corners += face.cornerCount;
+
+			}
+
+		};
+
+		if(createIndexedGeometry)
+		{
+			// Kept at most half full, as no object has more vertices than corners.
+			std::size_t tableSize = 1;
+			while(tableSize < faces.corners.size() * 2) tableSize *= 2;
+			std::vector<obj_index_t> table(tableSize, EMPTY_SLOT);
+			const obj_corner_hash_t hash;
+
+			auto addCorner = [&](const obj_corner_t &corner)
+			{
+				for(std::size_t slot = hash(corner) & (tableSize - 1);; slot = (slot + 1) & (tableSize - 1))
+				{
+					if(table[slot] == EMPTY_SLOT)
+					{
+						table[slot] = static_cast<obj_index_t>(vertices.size());
+						vertices.push_back(corner);
+						return table[slot];
+
+					}
+
+					if(vertices[table[slot]] == corner) return table[slot];
+
+				}
+
+			};
+
+			triangles.reserve(triangleCount);
+			triangulate([&](const obj_corner_t &a, const obj_corner_t &b, const obj_corner_t &c) { triangles.push_back({ addCorner(a), addCorner(b), addCorner(c) }); });
+
+		}
+		else
+		{
+			vertices.reserve(triangleCount * 3);
+			triangulate([&](const obj_corner_t &a, const obj_corner_t &b, const obj_corner_t &c) { vertices.insert(vertices.end(), { a, b, c }); });
+
+		}
+
+		std::vector<obj_corner_t>().swap(faces.corners);
+
+		// Vertex Streams
+		// A stream is written for every vertex as soon as any vertex has a record for it, so vertices of faces read before its first record
+		// receive zeros.  Returns the first vertex whose record could not be parsed, or the vertex count.
+		auto hasStream = [&](std::uint32_t obj_corner_t::*stream) { return std::any_of(vertices.begin(), vertices.end(), [&](const obj_corner_t &vertex) { return vertex.*stream != noStream; }); };
+
+		auto gather = [&](const auto &records, std::uint32_t obj_corner_t::*stream, auto &values)
+		{
+			if(!hasStream(stream)) return vertices.size();
+			values.reserve(vertices.size());
+
+			for(std::size_t vertex = 0; vertex < vertices.size(); ++vertex)
+			{
+				const std::uint32_t record = vertices[vertex].*stream;
+				typename std::decay<decltype(values)>::type::value_type value {};
+				if(record < noRecord && !records.Get(record, value)) return vertex;
+				values.push_back(value);
+
+			}
+
+			return vertices.size();
+
+		};
+
+		const std::size_t malformedVertex = std::min({ gather(positions, &obj_corner_t::position, object.positions), gather(normals, &obj_corner_t::normal, object.normals), gather(uvs, &obj_corner_t::uv, object.uvs) });
+		if(malformedVertex < vertices.size())
+		{
+			// Line of the face whose triangle first used the vertex
+			std::size_t triangle = malformedVertex / 3;
+			if(createIndexedGeometry) triangle = std::find_if(triangles.begin(), triangles.end(), [&](const obj_face3_t &t) { return t.a == malformedVertex || t.b == malformedVertex || t.c == malformedVertex; }) - triangles.begin();
+
+			for(const auto &face : faces.faces)
+			{
+				faces.malformedLineNo = face.lineNo;
+				if(triangle < face.cornerCount - 2) break;
+				triangle -= face.cornerCount - 2;
+
+			}
+
+			return;
+
+		}
+
+		if(hasStream(&obj_corner_t::uv2))
+		{
+			object.uvs2.reserve(vertices.size());
+			for(const auto &vertex : vertices)
+			{
+				obj_vector2_t uv2 {};
+				if(vertex.uv2 >= noRecord || !uvs2.Get(vertex.uv2, uv2)) ++faces.unmatchedUV2s;
+				object.uvs2.push_back(uv2);
+
+			}
+
+		}
+
+		std::vector<obj_face_t>().swap(faces.faces);
+
+	};
+
+	// Section Fingerprints
+	const std::unordered_map<std::uint64_t, bom_previous_section_t> *previousSections = nullptr;
+	if(previous)
+	{
+		auto previousAsset = previous->assets.find(objFilePath);
+		if(previousAsset != previous->assets.end()) previousSections = &previousAsset->second;
+
+	}
+
+	std::unordered_map<std::uint64_t, std::uint64_t> externalRecords; // Records preceding the section by stream and record number, in order of first use
+	obj_record_counts_t sectionStart {};
+	std::uint64_t sectionHash = 0;
+	std::size_t reusedSections = 0;
+
+	auto recordCounts = [&]() { return obj_record_counts_t { positions.size(), normals.size(), uvs.size(), uvs2.size() }; };
+	auto hashSection = [&sectionHash](const void *data, std::size_t size) { sectionHash = HashXXH64(data, size, sectionHash); };
+
+	// Faces are fingerprinted by the records their corners resolve to.  Records of the section itself are identified by their position within
+	// it, and earlier records by their content and order of first use, so that records added to or removed from earlier sections leave the
+	// fingerprint unchanged.
+	auto hashReference = [&](std::uint64_t stream, const auto &records, std::size_t start, std::uint32_t record)
+	{
+		std::uint64_t reference[2] = { stream, record };
+
+		if(record < noRecord && record >= start)
+		{
+			reference[1] = record - start;
+
+		}
+		else if(record < noRecord)
+		{
+			auto external = externalRecords.insert(std::make_pair(std::uint64_t(record) * 4 + stream, externalRecords.size()));
+			reference[1] = external.first->second | (std::uint64_t(1) << 63);
+
+			auto tokens = records.Tokens(record);
+			if(external.second) hashSection(tokens.cursor, tokens.end - tokens.cursor);
+
+		}
+
+		hashSection(reference, sizeof(reference));
+
+	};
+
+	auto hashFace = [&](const obj_corner_t *corners, std::uint32_t cornerCount)
+	{
+		for(std::uint32_t corner = 0; corner < cornerCount; ++corner)
+		{
+			hashReference(0, positions, sectionStart.positions, corners[corner].position);
+			hashReference(1, normals, sectionStart.normals, corners[corner].normal);
+			hashReference(2, uvs, sectionStart.uvs, corners[corner].uv);
+			hashReference(3, uvs2, sectionStart.uvs2, corners[corner].uv2);
+
+		}
+
+		hashSection(&cornerCount, sizeof(cornerCount));
+
+	};
+
+	// Completes the fingerprint of the current section with the material and smoothing its group ends up with, takes its objects from the
+	// previous conversion if it is unchanged, dropping the faces read for it, and begins the next section.
+	auto endSection = [&]()
+	{
+		if(!incrementalConversion) return;
+
+		const std::uint64_t state[2] = { objState->mtlState ? objState->mtlState->contentHash : 0, group->smoothing };
+		hashSection(group->materialName.data(), group->materialName.size());
+		hashSection(state, sizeof(state));
+		objState->sectionFingerprints.push_back(sectionHash);
+
+		if(previousSections)
+		{
+			auto previousSection = previousSections->find(sectionHash);
+			if(previousSection != previousSections->end())
+			{
+				for(std::size_t i = 0; i < previousSection->second.objectCount; ++i)
+				{
+					auto target = i == 0 ? object : std::make_shared<obj_object_t>();
+					RestoreObject(*previous->objects[previousSection->second.firstObject + i], *group, *target);
+					target->section = objState->sectionFingerprints.size() - 1;
+					if(i > 0) objState->objects.push_back(target);
+
+				}
+
+				objectFaces.back().faces.clear();
+				objectFaces.back().corners.clear();
+				++reusedSections;
+
+			}
+
+		}
+
+		sectionHash = 0;
+		sectionStart = recordCounts();
+		externalRecords.clear();
+
+	};
+
+	Log() << "Parsing OBJ '" << objFilePath << "'..." << std::endl;
+	while(std::getline(objFile, line))
+	{
+		++lineNo;
+		//Log() << line << "\n";
+		if(line.empty()) continue;
+
+		mtl_tokenizer_t tokens { line.data(), line.data() + line.size() };
+		mtl_token_t keyword;
+		const bool hasKeyword = tokens.Next(keyword);
+
+		// Faces are fingerprinted by the records they reference, and 'o' and 'g' entries as part of the section they begin.
+		if(incrementalConversion && !(hasKeyword && (keyword == "f" || keyword == "o" || keyword == "g"))) hashSection(line.data(), line.size());
+
+		// Vertex records make up most of a file, so they are kept, or skipped when their stream is dropped, without a string stream.
+		if(hasKeyword && keyword.data[0] == 'v')
+		{
+			if(keyword.size == 1)
+			{
+				positions.Add(tokens.cursor, tokens.end);
+				continue;
+
+			}
+			else if(keyword == "vn")
+			{
+				if(readNormals) normals.Add(tokens.cursor, tokens.end);
+				continue;
+
+			}
+			else if(keyword == "vt")
+			{
+				if(readUVs) addUVRecord(uvs, tokens);
+				continue;
+
+			}
+
+		}
+
+		std::istringstream iss(line);
+
+		std::string entryType;
+		if(!(iss >> entryType))
+		{
+			if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Failed to parse entry type." << std::endl;
+			return false;
+
+		}
+
+		if(entryType == "mtllib")
+		{
+			if(!(iss >> objState->materialFileName))
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
+				return false;
+
+			}
+			
+			objState->materialFileName = objState->materialFileName.substr(objState->materialFileName.find_last_of("/\\") + 1);
+
+			if(!ReadMTL(relativePath, objState))
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Failed to open material file '" << objState->materialFileName << "'" << std::endl;
+				return false;
+
+			}
+
+		}
+		else if(entryType == "g" || entryType == "o")
+		{
+			if(!isFirstObject) endSection();
+			if(incrementalConversion) hashSection(line.data(), line.size());
+
+			if(!isFirstGroup) group = std::make_shared<obj_group_t>();
+			if(!isFirstObject)
+			{
+				object = std::make_shared<obj_object_t>();
+				objectFaces.emplace_back();
+				objectFaces.back().object = object;
+				objectFaces.back().group = group;
+
+			}
+
+			object->section = objState->sectionFingerprints.size();
+
+			if(!(iss >> group->name))
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
+				return false;
+
+			}
+
+			group->materialName = objState->materialName;
+			group->materialId = objState->materialId;
+			group->smoothing = objState->smoothing;
+
+			object->groups.push_back(group);
+			isFirstGroup = false;
+			
+			objState->objects.push_back(object);
+			isFirstObject = false;
+
+		}
+		else if(entryType == "usemtl")
+		{
+			std::string materialName;
+			if(!(iss >> materialName))
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
+				return false;
+
+			}
+
+			// Consecutive groups commonly reuse the same material, so the name index is only consulted when it changes.
+			if(materialName != objState->materialName || objState->mtlState.get() != usedMtlState)
+			{
+				bool foundMaterial = false;
+
+				if(objState->mtlState)
+				{
+					auto material = objState->mtlState->materialIds.find(materialName);
+					if(material != objState->mtlState->materialIds.end())
+					{
+						objState->materialId = material->second;
+						foundMaterial = true;
+
+					}
+
+				}
+
+				if(!foundMaterial)
+				{
+					if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Could not find material '" << materialName << "'" << std::endl;
+					return false;
+
+				}
+
+				objState->materialName = materialName;
+				usedMtlState = objState->mtlState.get();
+
+			}
+
+			group->materialName = objState->materialName;
+			group->materialId = objState->materialId;
+
+		}
+		else if(entryType == "s")
+		{
+			std::string smoothing;
+			if(!(iss >> smoothing))
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
+				return false;
+
+			}
+
+			if(smoothing == "off") objState->smoothing = 0;
+			else if(smoothing == "on") objState->smoothing = 1;
+			else objState->smoothing = std::stoi(smoothing);
+
+			group->smoothing = objState->smoothing;
+
+		}
+		else if(entryType == "f")
+		{
+			int facePositions[5] = {}, faceUVs[5] = {}, faceNormals[5] = {};
+			const int cornerCount = ParseFace(line, facePositions, faceUVs, faceNormals);
+
+			if(cornerCount == 0)
+			{
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
+				return false;
+
+			}
+			else if(cornerCount > 4)
+			{
+				// N-gons
+				if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] N-gon geometry faces are not supported." << std::endl;
+				return false;
+
+			}
+			else if(cornerCount == 4)
+			{
+				// Quads
+				if(logWarnings) Log() << "WARNING: [" << objFilePath << ":" << lineNo << "] Quad geometry faces are automatically triangulated." << std::endl;
+
+			}
+
+			auto &faces = objectFaces.back();
+			for(int corner = 0; corner < cornerCount; ++corner)
+			{
+				obj_corner_t resolved;
+				if(!resolveCorner(facePositions[corner], faceNormals[corner], faceUVs[corner], resolved))
+				{
+					if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Face references a missing or malformed vertex record." << std::endl;
+					return false;
+
+				}
+
+				faces.corners.push_back(resolved);
+
+			}
+
+			faces.faces.push_back({ lineNo, static_cast<std::uint32_t>(cornerCount) });
+			if(incrementalConversion) hashFace(faces.corners.data() + faces.corners.size() - cornerCount, cornerCount);
+
+		}
+		else if(entryType == "#")
+		{
+			// Attempt to parse out vendor-specific geometry property
+			// # :<vendor>: <property> [value0] [value1] [valueN...]
+			if((iss >> entryType) && entryType == ":BOM:")
+			{
+				if(!(iss >> entryType))
+				{
+					if(logWarnings) Log() << "WARNING: [" << objFilePath << ":" << lineNo << "] Vendor-specific geometry entry type could not be parsed and will be skipped." << std::endl;
+					continue;
+
+				}
+
+				if(entryType == "vt2")
+				{
+					// UV Channel 2 (vt2)
+					// :BOM: vt2 <u> <v> [w]
+					const auto arguments = iss.eof() ? line.size() : static_cast<std::size_t>(iss.tellg());
+					if(readUV2s) addUVRecord(uvs2, mtl_tokenizer_t { line.data() + arguments, line.data() + line.size() });
+
+				}
+
+			}
+
+		}
+		else if(entryType == "p" || entryType == "l" || entryType == "curv" || entryType == "curv2" || entryType == "surf")
+		{
+			if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << lineNo << "] Geometry type '" << entryType << "' is not supported." << std::endl;
+			return false;
+
+		}
+		else
+		{
+			if(logWarnings) Log() << "WARNING: [" << objFilePath << ":" << lineNo << "] Skipping unsupported entry type '" << entryType << "'" << std::endl;
+
+		}
+
+	}
+
+	if(isFirstGroup) object->groups.push_back(group);
+	if(isFirstObject) objState->objects.push_back(object);
+	endSection();
+
+	if(previousSections) Log() << "Reused " << reusedSections << " of " << objState->sectionFingerprints.size() << " section(s) from the previous conversion." << std::endl;
+
+	// Objects are built largest first on up to one thread per worker, with each thread taking the next object once done with its last.  Files
+	// with few corners are built on the parsing thread alone.
+	std::vector<obj_object_faces_t*> buildOrder;
+	std::size_t cornerCount = 0;
+	for(auto &faces : objectFaces)
+	{
+		if(faces.faces.empty()) continue;
+		buildOrder.push_back(&faces);
+		cornerCount += faces.corners.size();
+
+	}
+
+	std::stable_sort(buildOrder.begin(), buildOrder.end(), [](const obj_object_faces_t *a, const obj_object_faces_t *b) { return a->corners.size() > b->corners.size(); });
+
+	std::atomic<std::size_t> nextObject { 0 };
+	auto buildObjects = [&]() { for(std::size_t i = nextObject++; i < buildOrder.size(); i = nextObject++) buildObject(*buildOrder[i]); };
+
+	const std::size_t taskCount = std::min<std::size_t>({ ConversionThreadCount(), buildOrder.size(), 1 + cornerCount / PARALLEL_CORNERS });
+	std::vector<std::future<void>> tasks;
+	for(std::size_t task = 1; task < taskCount; ++task) tasks.push_back(std::async(std::launch::async, buildObjects));
+	buildObjects();
+	for(auto &task : tasks) task.get();
+
+	for(const auto &faces : objectFaces)
+	{
+		if(faces.malformedLineNo != 0)
+		{
+			if(logErrors) Log() << "ERROR: [" << objFilePath << ":" << faces.malformedLineNo << "] Face references a missing or malformed vertex record." << std::endl;
+			return false;
+
+		}
+
+		unmatchedUV2s += faces.unmatchedUV2s;
+
+	}
+
+	if(unmatchedUV2s > 0 && logWarnings) Log() << "WARNING: [" << objFilePath << "] " << "Second UV channel of " << unmatchedUV2s << " vertex(es) set to zero, as no vt2 record matches their vt record." << std::endl;
+
+	asset->objStates.push_back(objState);
+	return true;
+
+}
+
+// Material Deduplication
+// Collapses materials with identical properties, regardless of name, in to their first occurrence and remaps group materials to match.
+std::size_t MergeMaterials(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	struct content_hash_t
+	{
+		std::size_t operator()(const std::string &content) const { return static_cast<std::size_t>(HashXXH64(content.data(), content.size())); }
+
+	};
+
+	std::unordered_map<std::string, std::uint32_t, content_hash_t> uniqueMaterials;
+	std::map<std::uint32_t, std::uint32_t> remappedIds;
+
+	// Materials are visited in the order they are written, so that the one kept of each set of duplicates does not depend on parse order.
+	for(const auto &material : CollectLibraryMaterialStates())
+	{
+		auto uniqueMaterial = uniqueMaterials.insert(std::make_pair(MaterialContent(*material.second), material.second->id));
+		if(uniqueMaterial.second) continue;
+
+		remappedIds.insert(std::make_pair(material.second->id, uniqueMaterial.first->second));
+		material.first->materials.erase(material.second->id);
+
+	}
+
+	if(remappedIds.empty()) return 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				for(const auto &group : object->groups)
+				{
+					auto remappedId = remappedIds.find(group->materialId);
+					if(remappedId != remappedIds.end()) group->materialId = remappedId->second;
+
+				}
+
+			}
+
+		}
+
+	}
+
+	Log() << "Merged " << remappedIds.size() << " duplicate material(s) in to " << uniqueMaterials.size() << " unique material(s)." << std::endl;
+	return remappedIds.size();
+
+}
+
+// Object Merging
+// Appends objects with at most maxVertices vertices to a shared vertex buffer, offsetting their indices, while the buffer remains indexable.
+std::size_t MergeObjects(const std::vector<std::shared_ptr<bom_asset_t>> &assets, std::size_t maxVertices)
+{
+	if(!createIndexedGeometry) return 0;
+
+	std::size_t mergedObjects = 0;
+
+	auto isCompatible = [](const obj_object_t &a, const obj_object_t &b)
+	{
+		return a.normals.empty() == b.normals.empty() && a.uvs.empty() == b.uvs.empty() && a.uvs2.empty() == b.uvs2.empty() && a.tangents.empty() == b.tangents.empty();
+
+	};
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			std::vector<std::shared_ptr<obj_object_t>> objects;
+			std::shared_ptr<obj_object_t> sharedObject;
+
+			for(const auto &object : objState->objects)
+			{
+				if(object->positions.empty() || object->positions.size() > maxVertices)
+				{
+					objects.push_back(object);
+					continue;
+
+				}
+
+				if(!sharedObject || !isCompatible(*sharedObject, *object) || sharedObject->positions.size() + object->positions.size() > maxIndexableVertices)
+				{
+					sharedObject = object;
+					objects.push_back(object);
+					continue;
+
+				}
+
+				auto baseIndex = static_cast<obj_index_t>(sharedObject->positions.size());
+				sharedObject->positions.insert(sharedObject->positions.end(), object->positions.begin(), object->positions.end());
+				sharedObject->normals.insert(sharedObject->normals.end(), object->normals.begin(), object->normals.end());
+				sharedObject->uvs.insert(sharedObject->uvs.end(), object->uvs.begin(), object->uvs.end());
+				sharedObject->uvs2.insert(sharedObject->uvs2.end(), object->uvs2.begin(), object->uvs2.end());
+				sharedObject->tangents.insert(sharedObject->tangents.end(), object->tangents.begin(), object->tangents.end());
+
+				for(const auto &group : object->groups)
+				{
+					for(auto &face : group->faces)
+					{
+						face.a += baseIndex;
+						face.b += baseIndex;
+						face.c += baseIndex;
+
+					}
+
+					sharedObject->groups.push_back(group);
+
+				}
+
+				++mergedObjects;
+
+			}
+
+			objState->objects.swap(objects);
+
+		}
+
+	}
+
+	return mergedObjects;
+
+}
+
+// Group Merging
+// Combines groups of the same object that share a material and smoothing group in to a single index range, keeping the first group's name.
+std::size_t MergeGroups(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	if(!createIndexedGeometry) return 0;
+
+	std::size_t mergedGroups = 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				std::map<std::tuple<bool, std::uint32_t, std::uint8_t>, std::shared_ptr<obj_group_t>> uniqueGroups;
+				std::vector<std::shared_ptr<obj_group_t>> groups;
+
+				for(const auto &group : object->groups)
+				{
+					auto key = std::make_tuple(group->materialName.empty(), group->materialName.empty() ? std::uint32_t(0) : group->materialId, group->smoothing);
+					auto uniqueGroup = uniqueGroups.insert(std::make_pair(key, group));
+					if(uniqueGroup.second)
+					{
+						groups.push_back(group);
+						continue;
+
+					}
+
+					auto &faces = uniqueGroup.first->second->faces;
+					faces.insert(faces.end(), group->faces.begin(), group->faces.end());
+					++mergedGroups;
+
+				}
+
+				object->groups.swap(groups);
+
+			}
+
+		}
+
+	}
+
+	return mergedGroups;
+
+}
+
+// Collects the corner indices of every triangle in an object, in group order, along with the group each triangle belongs to.
+void CollectTriangleCorners(obj_object_t &object, std::vector<obj_index_t*> &corners, std::vector<const obj_group_t*> &triangleGroups)
+{
+	for(const auto &group : object.groups)
+	{
+		for(auto &face : group->faces)
+		{
+			corners.push_back(&face.a);
+			corners.push_back(&face.b);
+			corners.push_back(&face.c);
+			triangleGroups.push_back(group.get());
+
+		}
+
+	}
+
+}
+
+// Builds the list of corners referencing each vertex, where the corners of vertex v are vertexCorners[cornerOffsets[v]] to vertexCorners[cornerOffsets[v + 1] - 1].
+void BuildVertexCorners(std::size_t vertexCount, const std::vector<obj_index_t*> &corners, std::vector<std::uint32_t> &cornerOffsets, std::vector<std::uint32_t> &vertexCorners)
+{
+	cornerOffsets.assign(vertexCount + 1, 0);
+	vertexCorners.resize(corners.size());
+
+	for(const auto &corner : corners) ++cornerOffsets[*corner + 1];
+	for(std::size_t v = 0; v < vertexCount; ++v) cornerOffsets[v + 1] += cornerOffsets[v];
+
+	auto cursor = cornerOffsets;
+	for(std::uint32_t c = 0; c < corners.size(); ++c) vertexCorners[cursor[*corners[c]]++] = c;
+
+}
+
+// Appends a copy of a vertex to every vertex stream of an object, returning the index of the copy.
+std::size_t DuplicateVertex(obj_object_t &object, std::size_t vertex)
+{
+	object.positions.push_back(object.positions[vertex]);
+	if(!object.normals.empty()) object.normals.push_back(object.normals[vertex]);
+	if(!object.uvs.empty()) object.uvs.push_back(object.uvs[vertex]);
+	if(!object.uvs2.empty()) object.uvs2.push_back(object.uvs2[vertex]);
+	if(!object.tangents.empty()) object.tangents.push_back(object.tangents[vertex]);
+	return object.positions.size() - 1;
+
+}
+
+// Vertex Transforms
+// The kernels below work directly on the contiguous float streams of obj_object_t.  Each has a scalar version that handles whole
+// streams on targets without SSE2 as well as the tail left over by the vector loops, and an AVX variant where the operation does
+// not cross vector boundaries, selected at run time.  The face normal kernels gather triangle corners instead, taking either the corner
+// index pointers of an indexed object or, without them, consecutive positions.
+void ScaleFloatsScalar(float *data, std::size_t count, float factor)
+{
+	for(std::size_t i = 0; i < count; ++i) data[i] *= factor;
+
+}
+
+void FlipVScalar(float *data, std::size_t count)
+{
+	for(std::size_t i = 1; i < count; i += 2) data[i] = 1.0f - data[i];
+
+}
+
+void SwapZUpScalar(float *data, std::size_t count)
+{
+	for(std::size_t i = 0; i + 2 < count; i += 3)
+	{
+		auto y = data[i + 1];
+		data[i + 1] = data[i + 2];
+		data[i + 2] = -y;
+
+	}
+
+}
+
+void NormalizeScalar(float *data, std::size_t count)
+{
+	for(std::size_t i = 0; i + 2 < count; i += 3)
+	{
+		auto lengthSquared = data[i] * data[i] + data[i + 1] * data[i + 1] + data[i + 2] * data[i + 2];
+		if(lengthSquared <= 0.0f) continue;
+
+		auto inverseLength = 1.0f / std::sqrt(lengthSquared);
+		data[i] *= inverseLength;
+		data[i + 1] *= inverseLength;
+		data[i + 2] *= inverseLength;
+
+	}
+
+}
+
+void FaceNormalsScalar(const obj_vector3_t *positions, obj_index_t *const *corners, std::size_t first, std::size_t count, obj_vector3_t *faceNormals, obj_vector3_t *unitNormals)
+{
+	for(std::size_t t = first; t < first + count; ++t)
+	{
+		const auto &a = positions[corners ? *corners[t * 3] : t * 3];
+		const auto &b = positions[corners ? *corners[t * 3 + 1] : t * 3 + 1];
+		const auto &c = positions[corners ? *corners[t * 3 + 2] : t * 3 + 2];
+		obj_vector3_t ab { b.x - a.x, b.y - a.y, b.z - a.z }, ac { c.x - a.x, c.y - a.y, c.z - a.z };
+		obj_vector3_t normal { ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x };
+
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		faceNormals[t] = normal;
+		unitNormals[t] = length > 0.0f ? obj_vector3_t { normal.x / length, normal.y / length, normal.z / length } : obj_vector3_t { 0.0f, 1.0f, 0.0f };
+
+	}
+
+}
+
+#ifdef OBJ2BOM_AVX
+__attribute__((target("avx"))) std::size_t ScaleFloatsAVX(float *data, std::size_t count, float factor)
+{
+	const __m256 scale = _mm256_set1_ps(factor);
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8) _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), scale));
+	return i;
+
+}
+
+__attribute__((target("avx"))) std::size_t FlipVAVX(float *data, std::size_t count)
+{
+	// v' = 1 - v, computed as (-v) + 1 on the odd lanes while the even (u) lanes pass through unchanged.
+	const __m256 sign = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+	const __m256 one = _mm256_setr_ps(0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f);
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8) _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_xor_ps(_mm256_loadu_ps(data + i), sign), one));
+	return i;
+
+}
+
+bool HasAVX()
+{
+	static const bool supported = __builtin_cpu_supports("avx") != 0;
+	return supported;
+
+}
+#endif
+
+#ifdef OBJ2BOM_SSE2
+std::size_t ScaleFloatsSSE(float *data, std::size_t count, float factor)
+{
+	const __m128 scale = _mm_set1_ps(factor);
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4) _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), scale));
+	return i;
+
+}
+
+std::size_t FlipVSSE(float *data, std::size_t count)
+{
+	const __m128 sign = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+	const __m128 one = _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f);
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4) _mm_storeu_ps(data + i, _mm_add_ps(_mm_xor_ps(_mm_loadu_ps(data + i), sign), one));
+	return i;
+
+}
+
+std::size_t SwapZUpSSE(float *data, std::size_t count)
+{
+	// Four vectors (x, y, z) are loaded as a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3 and rewritten as (x, z, -y) with shuffles.
+	const __m128 signA = _mm_setr_ps(0.0f, 0.0f, -0.0f, 0.0f);
+	const __m128 signB = _mm_setr_ps(0.0f, -0.0f, 0.0f, 0.0f);
+	const __m128 signC = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+	std::size_t i = 0;
+
+	for(; i + 12 <= count; i += 12)
+	{
+		__m128 a = _mm_loadu_ps(data + i), b = _mm_loadu_ps(data + i + 4), c = _mm_loadu_ps(data + i + 8);
+
+		__m128 outA = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128 outB = _mm_shuffle_ps(b, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 1, 0, 1));
+		__m128 outC = _mm_shuffle_ps(_mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 3, 3)), c, _MM_SHUFFLE(2, 3, 2, 0));
+
+		_mm_storeu_ps(data + i, _mm_xor_ps(outA, signA));
+		_mm_storeu_ps(data + i + 4, _mm_xor_ps(outB, signB));
+		_mm_storeu_ps(data + i + 8, _mm_xor_ps(outC, signC));
+
+	}
+
+	return i;
+
+}
+
+std::size_t NormalizeSSE(float *data, std::size_t count)
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	std::size_t i = 0;
+
+	for(; i + 12 <= count; i += 12)
+	{
+		__m128 a = _mm_loadu_ps(data + i), b = _mm_loadu_ps(data + i + 4), c = _mm_loadu_ps(data + i + 8);
+
+		// Transpose to x0-x3, y0-y3 and z0-z3 to compute four lengths at once.
+		__m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+
+		// Zero length vectors are left untouched, matching the scalar version.
+		__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 valid = _mm_cmpgt_ps(lengthSquared, zero);
+		__m128 inverse = _mm_div_ps(one, _mm_sqrt_ps(_mm_or_ps(_mm_and_ps(valid, lengthSquared), _mm_andnot_ps(valid, one))));
+
+		// Spread the four factors back over the interleaved layout: i0 i0 i0 i1, i1 i1 i2 i2, i2 i3 i3 i3.
+		_mm_storeu_ps(data + i, _mm_mul_ps(a, _mm_shuffle_ps(inverse, inverse, _MM_SHUFFLE(1, 0, 0, 0))));
+		_mm_storeu_ps(data + i + 4, _mm_mul_ps(b, _mm_shuffle_ps(inverse, inverse, _MM_SHUFFLE(2, 2, 1, 1))));
+		_mm_storeu_ps(data + i + 8, _mm_mul_ps(c, _mm_shuffle_ps(inverse, inverse, _MM_SHUFFLE(3, 3, 3, 2))));
+
+	}
+
+	return i;
+
+}
+
+std::size_t FaceNormalsSSE(const obj_vector3_t *positions, obj_index_t *const *corners, std::size_t count, obj_vector3_t *faceNormals, obj_vector3_t *unitNormals)
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	std::size_t t = 0;
+
+	for(; t + 4 <= count; t += 4)
+	{
+		// Gather the corners of four triangles transposed to one register per component, a lane per triangle.
+		const obj_vector3_t *p[12];
+		for(std::size_t i = 0; i < 12; ++i) p[i] = &positions[corners ? *corners[t * 3 + i] : t * 3 + i];
+
+		__m128 ax = _mm_setr_ps(p[0]->x, p[3]->x, p[6]->x, p[9]->x), ay = _mm_setr_ps(p[0]->y, p[3]->y, p[6]->y, p[9]->y), az = _mm_setr_ps(p[0]->z, p[3]->z, p[6]->z, p[9]->z);
+		__m128 bx = _mm_setr_ps(p[1]->x, p[4]->x, p[7]->x, p[10]->x), by = _mm_setr_ps(p[1]->y, p[4]->y, p[7]->y, p[10]->y), bz = _mm_setr_ps(p[1]->z, p[4]->z, p[7]->z, p[10]->z);
+		__m128 cx = _mm_setr_ps(p[2]->x, p[5]->x, p[8]->x, p[11]->x), cy = _mm_setr_ps(p[2]->y, p[5]->y, p[8]->y, p[11]->y), cz = _mm_setr_ps(p[2]->z, p[5]->z, p[8]->z, p[11]->z);
+
+		__m128 abx = _mm_sub_ps(bx, ax), aby = _mm_sub_ps(by, ay), abz = _mm_sub_ps(bz, az);
+		__m128 acx = _mm_sub_ps(cx, ax), acy = _mm_sub_ps(cy, ay), acz = _mm_sub_ps(cz, az);
+		__m128 nx = _mm_sub_ps(_mm_mul_ps(aby, acz), _mm_mul_ps(abz, acy));
+		__m128 ny = _mm_sub_ps(_mm_mul_ps(abz, acx), _mm_mul_ps(abx, acz));
+		__m128 nz = _mm_sub_ps(_mm_mul_ps(abx, acy), _mm_mul_ps(aby, acx));
+
+		// Divides by the length rather than multiplying by its inverse, and substitutes +Y for degenerate triangles, so the results
+		// are bit identical to the scalar version.
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+		__m128 valid = _mm_cmpgt_ps(length, zero);
+		__m128 divisor = _mm_or_ps(_mm_and_ps(valid, length), _mm_andnot_ps(valid, one));
+		__m128 ux = _mm_and_ps(valid, _mm_div_ps(nx, divisor));
+		__m128 uy = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(ny, divisor)), _mm_andnot_ps(valid, one));
+		__m128 uz = _mm_and_ps(valid, _mm_div_ps(nz, divisor));
+
+		alignas(16) float out[6][4];
+		_mm_store_ps(out[0], nx);
+		_mm_store_ps(out[1], ny);
+		_mm_store_ps(out[2], nz);
+		_mm_store_ps(out[3], ux);
+		_mm_store_ps(out[4], uy);
+		_mm_store_ps(out[5], uz);
+
+		for(std::size_t i = 0; i < 4; ++i)
+		{
+			faceNormals[t + i] = { out[0][i], out[1][i], out[2][i] };
+			unitNormals[t + i] = { out[3][i], out[4][i], out[5][i] };
+
+		}
+
+	}
+
+	return t;
+
+}
+#endif
+
+void ScaleFloats(float *data, std::size_t count, float factor)
+{
+	std::size_t done = 0;
+#ifdef OBJ2BOM_AVX
+	if(HasAVX()) done = ScaleFloatsAVX(data, count, factor);
+#endif
+#ifdef OBJ2BOM_SSE2
+	done += ScaleFloatsSSE(data + done, count - done, factor);
+#endif
+	ScaleFloatsScalar(data + done, count - done, factor);
+
+}
+
+void FlipV(float *data, std::size_t count)
+{
+	std::size_t done = 0;
+#ifdef OBJ2BOM_AVX
+	if(HasAVX()) done = FlipVAVX(data, count);
+#endif
+#ifdef OBJ2BOM_SSE2
+	done += FlipVSSE(data + done, count - done);
+#endif
+	FlipVScalar(data + done, count - done);
+
+}
+
+void SwapZUp(float *data, std::size_t count)
+{
+	std::size_t done = 0;
+#ifdef OBJ2BOM_SSE2
+	done = SwapZUpSSE(data, count);
+#endif
+	SwapZUpScalar(data + done, count - done);
+
+}
+
+void Normalize(float *data, std::size_t count)
+{
+	std::size_t done = 0;
+#ifdef OBJ2BOM_SSE2
+	done = NormalizeSSE(data, count);
+#endif
+	NormalizeScalar(data + done, count - done);
+
+}
+
+// Computes the unnormalized face normal and the unit face normal of every triangle.  Degenerate triangles get a unit normal of +Y.
+void FaceNormals(const obj_vector3_t *positions, obj_index_t *const *corners, std::size_t triangleCount, obj_vector3_t *faceNormals, obj_vector3_t *unitNormals)
+{
+	std::size_t done = 0;
+#ifdef OBJ2BOM_SSE2
+	done = FaceNormalsSSE(positions, corners, triangleCount, faceNormals, unitNormals);
+#endif
+	FaceNormalsScalar(positions, corners, done, triangleCount - done, faceNormals, unitNormals);
+
+}
+
+// Applies the requested flip, axis conversion, scale and normal renormalization to every object.  Runs before normals, tangents and
+// bounds are generated so that those are derived from the transformed data.
+void TransformVertices(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	std::size_t transformedVertices = 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				if(object->reused || object->positions.empty()) continue;
+
+				auto positions = &object->positions.data()->x;
+				auto normals = object->normals.empty() ? nullptr : &object->normals.data()->x;
+
+				if(zUpToYUp)
+				{
+					SwapZUp(positions, object->positions.size() * 3);
+					if(normals) SwapZUp(normals, object->normals.size() * 3);
+
+				}
+
+				if(unitScale != 1.0f) ScaleFloats(positions, object->positions.size() * 3, unitScale);
+
+				if(normalizeNormals && normals) Normalize(normals, object->normals.size() * 3);
+
+				if(flipV)
+				{
+					if(!object->uvs.empty()) FlipV(&object->uvs.data()->x, object->uvs.size() * 2);
+					if(!object->uvs2.empty()) FlipV(&object->uvs2.data()->x, object->uvs2.size() * 2);
+
+				}
+
+				transformedVertices += object->positions.size();
+
+			}
+
+		}
+
+	}
+
+	Log() << "Transformed " << transformedVertices << " vertices." << std::endl;
+
+}
+
+// Vertex Welding
+// Merges vertices whose positions, normals, UVs and tangents all lie within the tolerance of an earlier vertex, using a spatial hash
+// grid over quantized positions to find candidates, then drops triangles that collapse as a result.  Returns the number of vertices removed.
+std::size_t WeldObjectVertices(obj_object_t &object, float tolerance, std::size_t &removedTriangles)
+{
+	const auto vertexCount = object.positions.size();
+	const float cellSize = tolerance > 0.0f ? tolerance : 1.0f;
+
+	auto withinTolerance = [tolerance](const float *a, const float *b, std::size_t count)
+	{
+		for(std::size_t i = 0; i < count; ++i) if(std::fabs(a[i] - b[i]) > tolerance) return false;
+		return true;
+
+	};
+
+	auto isDuplicate = [&](std::size_t a, std::size_t b)
+	{
+		return withinTolerance(&object.positions[a].x, &object.positions[b].x, 3)
+			&& (object.normals.empty() || withinTolerance(&object.normals[a].x, &object.normals[b].x, 3))
+			&& (object.uvs.empty() || withinTolerance(&object.uvs[a].x, &object.uvs[b].x, 2))
+			&& (object.uvs2.empty() || withinTolerance(&object.uvs2[a].x, &object.uvs2[b].x, 2))
+			&& (object.tangents.empty() || withinTolerance(&object.tangents[a].x, &object.tangents[b].x, 4));
+
+	};
+
+	// Quantizes a coordinate to its cell.  Coordinates beyond the range of the grid, which huge values or a tiny tolerance produce, share its
+	// outermost cells rather than overflowing the conversion, leaving room for the neighbouring cells searched around them.
+	auto cellIndex = [cellSize](float coordinate)
+	{
+		static const float LIMIT = 4611686018427387904.0f; // 2^62
+
+		const float cell = std::floor(coordinate / cellSize);
+		if(std::isnan(cell)) return std::int64_t(0);
+		return static_cast<std::int64_t>(std::max(-LIMIT, std::min(cell, LIMIT)));
+
+	};
+
+	auto cellKey = [](std::int64_t x, std::int64_t y, std::int64_t z)
+	{
+		return static_cast<std::uint64_t>(x) * 0x9E3779B185EBCA87ULL ^ static_cast<std::uint64_t>(y) * 0xC2B2AE3D27D4EB4FULL ^ static_cast<std::uint64_t>(z) * 0x165667B19E3779F9ULL;
+
+	};
+
+	// Each grid cell lists the welded vertices whose positions fall within it, identified by their original index.
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> grid;
+	grid.reserve(vertexCount);
+
+	std::vector<std::uint32_t> remap(vertexCount), kept;
+	kept.reserve(vertexCount);
+
+	for(std::size_t v = 0; v < vertexCount; ++v)
+	{
+		const auto &position = object.positions[v];
+		const std::int64_t x = cellIndex(position.x), y = cellIndex(position.y), z = cellIndex(position.z);
+
+		// Vertices within the tolerance may straddle a cell boundary, so neighbouring cells are searched as well, unless welding exact duplicates.
+		const std::int64_t reach = tolerance > 0.0f ? 1 : 0;
+		bool welded = false;
+
+		for(std::int64_t dx = -reach; dx <= reach && !welded; ++dx)
+		{
+			for(std::int64_t dy = -reach; dy <= reach && !welded; ++dy)
+			{
+				for(std::int64_t dz = -reach; dz <= reach && !welded; ++dz)
+				{
+					auto cell = grid.find(cellKey(x + dx, y + dy, z + dz));
+					if(cell == grid.end()) continue;
+
+					for(auto candidate : cell->second)
+					{
+						if(!isDuplicate(candidate, v)) continue;
+
+						remap[v] = remap[candidate];
+						welded = true;
+						break;
+
+					}
+
+				}
+
+			}
+
+		}
+
+		if(welded) continue;
+
+		remap[v] = kept.size();
+		kept.push_back(v);
+		grid[cellKey(x, y, z)].push_back(v);
+
+	}
+
+	const auto removedVertices = vertexCount - kept.size();
+	removedTriangles = 0;
+	if(removedVertices == 0) return 0;
+
+	// Compact Vertex Streams
+	auto compact = [&kept](auto &stream)
+	{
+		if(stream.empty()) return;
+		for(std::size_t i = 0; i < kept.size(); ++i) stream[i] = stream[kept[i]];
+		stream.resize(kept.size());
+
+	};
+
+	compact(object.positions);
+	compact(object.normals);
+	compact(object.uvs);
+	compact(object.uvs2);
+	compact(object.tangents);
+
+	// Remap Indices And Drop Collapsed Triangles
+	for(const auto &group : object.groups)
+	{
+		std::vector<obj_face3_t> faces;
+		faces.reserve(group->faces.size());
+
+		for(const auto &face : group->faces)
+		{
+			obj_face3_t weldedFace = { static_cast<obj_index_t>(remap[face.a]), static_cast<obj_index_t>(remap[face.b]), static_cast<obj_index_t>(remap[face.c]) };
+			if(weldedFace.a == weldedFace.b || weldedFace.b == weldedFace.c || weldedFace.a == weldedFace.c) ++removedTriangles;
+			else faces.push_back(weldedFace);
+
+		}
+
+		group->faces.swap(faces);
+
+	}
+
+	return removedVertices;
+
+}
+
+std::size_t WeldVertices(const std::vector<std::shared_ptr<bom_asset_t>> &assets, float tolerance)
+{
+	if(!createIndexedGeometry) return 0;
+
+	std::size_t originalVertices = 0, removedVertices = 0, removedTriangles = 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				if(object->reused) continue;
+
+				std::size_t objectRemovedTriangles = 0;
+				originalVertices += object->positions.size();
+				removedVertices += WeldObjectVertices(*object, tolerance, objectRemovedTriangles);
+				removedTriangles += objectRemovedTriangles;
+
+			}
+
+		}
+
+	}
+
+	auto reduction = originalVertices > 0 ? 100.0 * removedVertices / originalVertices : 0.0;
+	Log() << "Welded " << originalVertices << " vertices in to " << (originalVertices - removedVertices) << " (" << reduction << "% reduction), removing " << removedTriangles << " collapsed triangle(s)." << std::endl;
+	return removedVertices;
+
+}
+
+// Normal Generation
+// Computes area or angle weighted vertex normals for an object without normals, splitting vertices shared by faces of different smoothing
+// groups, faces with smoothing disabled or faces whose normals differ by more than the crease angle.  Returns the number of vertices added.
+std::size_t GenerateObjectNormals(obj_object_t &object)
+{
+	auto subtract = [](const obj_vector3_t &a, const obj_vector3_t &b) { return obj_vector3_t { a.x - b.x, a.y - b.y, a.z - b.z }; };
+	auto dot = [](const obj_vector3_t &a, const obj_vector3_t &b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+	auto normalize = [&dot](const obj_vector3_t &a)
+	{
+		float length = std::sqrt(dot(a, a));
+		return length > 0.0f ? obj_vector3_t { a.x / length, a.y / length, a.z / length } : obj_vector3_t { 0.0f, 1.0f, 0.0f };
+
+	};
+
+	if(!createIndexedGeometry)
+	{
+		// Non-indexed geometry shares no vertices between triangles, so each triangle receives its face normal.
+		const auto triangleCount = object.positions.size() / 3;
+		std::vector<obj_vector3_t> faceNormals(triangleCount), unitNormals(triangleCount);
+		FaceNormals(object.positions.data(), nullptr, triangleCount, faceNormals.data(), unitNormals.data());
+
+		object.normals.resize(object.positions.size());
+		for(std::size_t t = 0; t < triangleCount; ++t) object.normals[t * 3] = object.normals[t * 3 + 1] = object.normals[t * 3 + 2] = unitNormals[t];
+
+		return 0;
+
+	}
+
+	std::vector<obj_index_t*> corners;
+	std::vector<const obj_group_t*> triangleGroups;
+	CollectTriangleCorners(object, corners, triangleGroups);
+
+	const auto triangleCount = triangleGroups.size();
+	const auto vertexCount = object.positions.size();
+
+	// Face Normals
+	// The unnormalized cross product has a length of twice the triangle area, giving area weighting for free.  The unit normals are
+	// computed once per triangle here rather than for each of its corners below.
+	std::vector<obj_vector3_t> faceNormals(triangleCount), unitFaceNormals(triangleCount), cornerWeights;
+	FaceNormals(object.positions.data(), corners.data(), triangleCount, faceNormals.data(), unitFaceNormals.data());
+
+	if(angleWeightedNormals)
+	{
+		cornerWeights.resize(triangleCount);
+		for(std::size_t t = 0; t < triangleCount; ++t)
+		{
+			const auto &a = object.positions[*corners[t * 3]], &b = object.positions[*corners[t * 3 + 1]], &c = object.positions[*corners[t * 3 + 2]];
+			auto ab = subtract(b, a), ac = subtract(c, a), bc = subtract(c, b);
+			auto angle = [&dot](const obj_vector3_t &u, const obj_vector3_t &v)
+			{
+				float lengths = std::sqrt(dot(u, u) * dot(v, v));
+				return lengths > 0.0f ? std::acos(std::max(-1.0f, std::min(1.0f, dot(u, v) / lengths))) : 0.0f;
+
+			};
+
+			cornerWeights[t] = { angle(ab, ac), angle(subtract(a, b), bc), angle(subtract(a, c), subtract(b, c)) };
+
+		}
+
+	}
+
+	std::vector<std::uint32_t> cornerOffsets, vertexCorners;
+	BuildVertexCorners(vertexCount, corners, cornerOffsets, vertexCorners);
+
+	const float creaseCosine = std::cos(creaseAngle * 3.14159265358979f / 180.0f);
+	const float flatCosine = 0.99999f;
+
+	struct cluster_t
+	{
+		std::uint8_t smoothing;
+		obj_vector3_t seed, normal;
+		std::size_t vertex;
+
+	};
+
+	std::vector<cluster_t> clusters;
+	object.normals.assign(vertexCount, obj_vector3_t { 0.0f, 1.0f, 0.0f });
+	std::size_t addedVertices = 0;
+
+	for(std::size_t v = 0; v < vertexCount; ++v)
+	{
+		clusters.clear();
+
+		for(auto i = cornerOffsets[v]; i < cornerOffsets[v + 1]; ++i)
+		{
+			auto corner = vertexCorners[i];
+			auto triangle = corner / 3;
+			const auto &faceNormal = unitFaceNormals[triangle];
+			auto weight = faceNormals[triangle];
+			if(angleWeightedNormals)
+			{
+				float cornerAngle = corner % 3 == 0 ? cornerWeights[triangle].x : (corner % 3 == 1 ? cornerWeights[triangle].y : cornerWeights[triangle].z);
+				weight = { faceNormal.x * cornerAngle, faceNormal.y * cornerAngle, faceNormal.z * cornerAngle };
+
+			}
+
+			// Corners share a normal when they belong to the same smoothing group and lie within the crease angle of the group's first face.
+			cluster_t *cluster = nullptr;
+			const auto smoothing = triangleGroups[triangle]->smoothing;
+			for(auto &candidate : clusters)
+			{
+				if(candidate.smoothing == smoothing && dot(candidate.seed, faceNormal) >= (smoothing == 0 ? flatCosine : creaseCosine))
+				{
+					cluster = &candidate;
+					break;
+
+				}
+
+			}
+
+			if(!cluster)
+			{
+				std::size_t vertex = v;
+				if(!clusters.empty())
+				{
+					vertex = DuplicateVertex(object, v);
+					++addedVertices;
+
+				}
+
+				clusters.push_back({ smoothing, faceNormal, { 0.0f, 0.0f, 0.0f }, vertex });
+				cluster = &clusters.back();
+
+			}
+
+			cluster->normal = { cluster->normal.x + weight.x, cluster->normal.y + weight.y, cluster->normal.z + weight.z };
+			*corners[corner] = static_cast<obj_index_t>(cluster->vertex);
+
+		}
+
+		for(const auto &cluster : clusters) object.normals[cluster.vertex] = normalize(cluster.normal);
+
+	}
+
+	return addedVertices;
+
+}
+
+void GenerateNormals(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	std::size_t generatedObjects = 0, addedVertices = 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				if(object->reused || object->positions.empty() || !object->normals.empty()) continue;
+
+				addedVertices += GenerateObjectNormals(*object);
+				++generatedObjects;
+
+			}
+
+		}
+
+	}
+
+	if(generatedObjects > 0) Log() << "Generated normals for " << generatedObjects << " object(s), adding " << addedVertices << " split vertices." << std::endl;
+
+}
+
+// Tangent Generation
+// Computes per-vertex tangents with bitangent handedness from UV gradients, splitting vertices whose triangles disagree on handedness
+// (mirrored UVs) or whose tangent directions diverge by more than 90 degrees.  Requires normals and UVs, returns the number of vertices added.
+std::size_t GenerateObjectTangents(obj_object_t &object)
+{
+	auto cross = [](const obj_vector3_t &a, const obj_vector3_t &b) { return obj_vector3_t { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; };
+	auto subtract = [](const obj_vector3_t &a, const obj_vector3_t &b) { return obj_vector3_t { a.x - b.x, a.y - b.y, a.z - b.z }; };
+	auto scale = [](const obj_vector3_t &a, float s) { return obj_vector3_t { a.x * s, a.y * s, a.z * s }; };
+	auto dot = [](const obj_vector3_t &a, const obj_vector3_t &b) { return a.x * b.x + a.y * b.y + a.z * b.z; };
+	auto length = [&dot](const obj_vector3_t &a) { return std::sqrt(dot(a, a)); };
+
+	// Removes the normal component of a tangent, falling back to an arbitrary perpendicular direction for degenerate tangents.
+	auto orthogonalize = [&](const obj_vector3_t &tangent, const obj_vector3_t &normal)
+	{
+		auto projected = subtract(tangent, scale(normal, dot(normal, tangent)));
+		auto projectedLength = length(projected);
+		if(projectedLength > 1e-12f) return scale(projected, 1.0f / projectedLength);
+
+		auto axis = std::fabs(normal.x) < 0.9f ? obj_vector3_t { 1.0f, 0.0f, 0.0f } : obj_vector3_t { 0.0f, 1.0f, 0.0f };
+		auto perpendicular = cross(normal, axis);
+		auto perpendicularLength = length(perpendicular);
+		return perpendicularLength > 0.0f ? scale(perpendicular, 1.0f / perpendicularLength) : obj_vector3_t { 1.0f, 0.0f, 0.0f };
+
+	};
+
+	// Triangle tangent and bitangent following the UV gradients, weighted by triangle area.
+	auto triangleFrame = [&](std::size_t a, std::size_t b, std::size_t c, obj_vector3_t &tangent, obj_vector3_t &bitangent)
+	{
+		auto edge1 = subtract(object.positions[b], object.positions[a]), edge2 = subtract(object.positions[c], object.positions[a]);
+		float du1 = object.uvs[b].x - object.uvs[a].x, dv1 = object.uvs[b].y - object.uvs[a].y;
+		float du2 = object.uvs[c].x - object.uvs[a].x, dv2 = object.uvs[c].y - object.uvs[a].y;
+		float determinant = du1 * dv2 - du2 * dv1;
+
+		tangent = bitangent = { 0.0f, 0.0f, 0.0f };
+		if(std::fabs(determinant) < 1e-20f) return;
+
+		tangent = scale(subtract(scale(edge1, dv2), scale(edge2, dv1)), 1.0f / determinant);
+		bitangent = scale(subtract(scale(edge2, du1), scale(edge1, du2)), 1.0f / determinant);
+
+		float area = 0.5f * length(cross(edge1, edge2)), tangentLength = length(tangent);
+		if(tangentLength > 0.0f) tangent = scale(tangent, area / tangentLength);
+
+	};
+
+	if(!createIndexedGeometry)
+	{
+		// Non-indexed geometry shares no vertices between triangles, so each vertex receives its triangle's tangent.
+		object.tangents.resize(object.positions.size());
+		for(std::size_t i = 0; i + 2 < object.positions.size(); i += 3)
+		{
+			obj_vector3_t tangent, bitangent;
+			triangleFrame(i, i + 1, i + 2, tangent, bitangent);
+
+			for(std::size_t v = i; v < i + 3; ++v)
+			{
+				auto vertexTangent = orthogonalize(tangent, object.normals[v]);
+				float handedness = dot(cross(object.normals[v], vertexTangent), bitangent) < 0.0f ? -1.0f : 1.0f;
+				object.tangents[v] = { vertexTangent.x, vertexTangent.y, vertexTangent.z, handedness };
+
+			}
+
+		}
+
+		return 0;
+
+	}
+
+	std::vector<obj_index_t*> corners;
+	std::vector<const obj_group_t*> triangleGroups;
+	CollectTriangleCorners(object, corners, triangleGroups);
+
+	const auto triangleCount = triangleGroups.size();
+	const auto vertexCount = object.positions.size();
+
+	std::vector<obj_vector3_t> triangleTangents(triangleCount), triangleBitangents(triangleCount);
+	for(std::size_t t = 0; t < triangleCount; ++t) triangleFrame(*corners[t * 3], *corners[t * 3 + 1], *corners[t * 3 + 2], triangleTangents[t], triangleBitangents[t]);
+
+	std::vector<std::uint32_t> cornerOffsets, vertexCorners;
+	BuildVertexCorners(vertexCount, corners, cornerOffsets, vertexCorners);
+
+	struct cluster_t
+	{
+		float handedness;
+		obj_vector3_t seed, tangent;
+		std::size_t vertex;
+
+	};
+
+	std::vector<cluster_t> clusters;
+	object.tangents.assign(vertexCount, obj_vector4_t { 1.0f, 0.0f, 0.0f, 1.0f });
+	std::size_t addedVertices = 0;
+
+	for(std::size_t v = 0; v < vertexCount; ++v)
+	{
+		clusters.clear();
+		const auto normal = object.normals[v];
+
+		for(auto i = cornerOffsets[v]; i < cornerOffsets[v + 1]; ++i)
+		{
+			auto corner = vertexCorners[i];
+			auto triangle = corner / 3;
+			auto direction = orthogonalize(triangleTangents[triangle], normal);
+			float handedness = dot(cross(normal, direction), triangleBitangents[triangle]) < 0.0f ? -1.0f : 1.0f;
+
+			cluster_t *cluster = nullptr;
+			for(auto &candidate : clusters)
+			{
+				if(candidate.handedness == handedness && dot(candidate.seed, direction) > 0.0f)
+				{
+					cluster = &candidate;
+					break;
+
+				}
+
+			}
+
+			if(!cluster)
+			{
+				std::size_t vertex = v;
+				if(!clusters.empty())
+				{
+					vertex = DuplicateVertex(object, v);
+					++addedVertices;
+
+				}
+
+				clusters.push_back({ handedness, direction, { 0.0f, 0.0f, 0.0f }, vertex });
+				cluster = &clusters.back();
+
+			}
+
+			const auto &weighted = triangleTangents[triangle];
+			cluster->tangent = { cluster->tangent.x + weighted.x, cluster->tangent.y + weighted.y, cluster->tangent.z + weighted.z };
+			*corners[corner] = static_cast<obj_index_t>(cluster->vertex);
+
+		}
+
+		for(const auto &cluster : clusters)
+		{
+			auto tangent = orthogonalize(cluster.tangent, normal);
+			object.tangents[cluster.vertex] = { tangent.x, tangent.y, tangent.z, cluster.handedness };
+
+		}
+
+	}
+
+	return addedVertices;
+
+}
+
+// Generates tangents for objects containing groups that use bump or normal mapped materials.
+void GenerateTangents(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	const auto tangentSpaceMaps = BitmaskFlag(MaterialDataAttribute::BUMP_MAP) | BitmaskFlag(MaterialDataAttribute::NORMAL_MAP);
+	std::set<std::uint32_t> bumpMappedMaterials;
+	std::size_t generatedObjects = 0, addedVertices = 0;
+
+	for(const auto &mtlState : mtlStates)
+	{
+		for(const auto &material : mtlState->materials)
+		{
+			if(WrittenAttributes(*material.second) & tangentSpaceMaps) bumpMappedMaterials.insert(material.first);
+
+		}
+
+	}
+
+	if(bumpMappedMaterials.empty()) return;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				if(object->reused) continue;
+
+				bool isBumpMapped = false;
+				for(const auto &group : object->groups) isBumpMapped |= !group->materialName.empty() && bumpMappedMaterials.count(group->materialId) > 0;
+				if(!isBumpMapped || object->positions.empty() || !object->tangents.empty()) continue;
+
+				if(object->normals.empty() || object->uvs.empty())
+				{
+					if(logWarnings) Log() << "WARNING: [" << asset->name << "] Tangents require vertex normals and UVs, skipping tangent generation for a bump mapped object." << std::endl;
+					continue;
+
+				}
+
+				addedVertices += GenerateObjectTangents(*object);
+				++generatedObjects;
+
+			}
+
+		}
+
+	}
+
+	if(generatedObjects > 0) Log() << "Generated tangents for " << generatedObjects << " object(s), adding " << addedVertices << " split vertices." << std::endl;
+
+}
+
+// Bounding Volumes
+// Computes the axis-aligned bounding box of a set of vertices and a bounding sphere centred on it, visiting each vertex through the given accessor.
+template <typename VertexAccessor>
+obj_bounds_t MakeBounds(std::size_t count, VertexAccessor vertex)
+{
+	obj_bounds_t bounds = {};
+	if(count == 0) return bounds;
+
+	bounds.min = bounds.max = vertex(0);
+	for(std::size_t i = 1; i < count; ++i)
+	{
+		const auto &position = vertex(i);
+		bounds.min.x = std::min(bounds.min.x, position.x);
+		bounds.min.y = std::min(bounds.min.y, position.y);
+		bounds.min.z = std::min(bounds.min.z, position.z);
+		bounds.max.x = std::max(bounds.max.x, position.x);
+		bounds.max.y = std::max(bounds.max.y, position.y);
+		bounds.max.z = std::max(bounds.max.z, position.z);
+
+	}
+
+	bounds.center = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+
+	float radiusSquared = 0.0f;
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		const auto &position = vertex(i);
+		float dx = position.x - bounds.center.x, dy = position.y - bounds.center.y, dz = position.z - bounds.center.z;
+		radiusSquared = std::max(radiusSquared, dx * dx + dy * dy + dz * dz);
+
+	}
+
+	bounds.radius = std::sqrt(radiusSquared);
+	return bounds;
+
+}
+
+// Object Chunking
+// Splits an object with more vertices than a 16-bit index can address in to chunks that each fit.  Triangles are visited in Morton
+// order of their centroids so that every chunk covers a compact region and culls well, and each chunk keeps the groups, materials and
+// smoothing of the triangles it receives.
+std::vector<std::shared_ptr<obj_object_t>> SplitObject(const obj_object_t &object)
+{
+	struct split_triangle_t
+	{
+		std::uint32_t code;
+		std::uint32_t group;
+		obj_face3_t face;
+
+	};
+
+	// Spreads the low 10 bits of a value so that two zero bits follow each one.
+	auto expandBits = [](std::uint32_t value)
+	{
+		value = (value * 0x00010001u) & 0xFF0000FFu;
+		value = (value * 0x00000101u) & 0x0F00F00Fu;
+		value = (value * 0x00000011u) & 0xC30C30C3u;
+		value = (value * 0x00000005u) & 0x49249249u;
+		return value;
+
+	};
+
+	const auto &positions = object.positions;
+	auto bounds = MakeBounds(positions.size(), [&positions](std::size_t i) { return positions[i]; });
+	obj_vector3_t extent { std::max(bounds.max.x - bounds.min.x, 1e-20f), std::max(bounds.max.y - bounds.min.y, 1e-20f), std::max(bounds.max.z - bounds.min.z, 1e-20f) };
+
+	auto quantize = [](float value, float minimum, float range)
+	{
+		return static_cast<std::uint32_t>(std::min(std::max((value - minimum) / range, 0.0f), 1.0f) * 1023.0f);
+
+	};
+
+	std::vector<split_triangle_t> triangles;
+	for(std::uint32_t g = 0; g < object.groups.size(); ++g)
+	{
+		for(const auto &face : object.groups[g]->faces)
+		{
+			const auto &a = positions[face.a], &b = positions[face.b], &c = positions[face.c];
+			auto x = quantize((a.x + b.x + c.x) / 3.0f, bounds.min.x, extent.x);
+			auto y = quantize((a.y + b.y + c.y) / 3.0f, bounds.min.y, extent.y);
+			auto z = quantize((a.z + b.z + c.z) / 3.0f, bounds.min.z, extent.z);
+			triangles.push_back({ (expandBits(x) << 2) | (expandBits(y) << 1) | expandBits(z), g, face });
+
+		}
+
+	}
+
+	std::stable_sort(triangles.begin(), triangles.end(), [](const split_triangle_t &a, const split_triangle_t &b) { return a.code < b.code; });
+
+	std::vector<std::shared_ptr<obj_object_t>> chunks;
+	std::vector<std::int64_t> remap(positions.size(), -1);
+	std::vector<obj_index_t> chunkVertices;
+	std::size_t first = 0;
+
+	while(first < triangles.size())
+	{
+		// Gather as many consecutive triangles as fit in to one chunk.
+		std::size_t last = first;
+		for(; last < triangles.size(); ++last)
+		{
+			const auto &face = triangles[last].face;
+			std::size_t newVertices = (remap[face.a] < 0) + (remap[face.b] < 0 && face.b != face.a) + (remap[face.c] < 0 && face.c != face.a && face.c != face.b);
+			if(chunkVertices.size() + newVertices > maxIndexableVertices) break;
+
+			for(auto vertex : { face.a, face.b, face.c })
+			{
+				if(remap[vertex] >= 0) continue;
+				remap[vertex] = chunkVertices.size();
+				chunkVertices.push_back(vertex);
+
+			}
+
+		}
+
+		auto chunk = std::make_shared<obj_object_t>();
+		chunk->section = object.section;
+		auto copyStream = [&chunkVertices](const auto &source, auto &target)
+		{
+			if(source.empty()) return;
+			target.reserve(chunkVertices.size());
+			for(auto vertex : chunkVertices) target.push_back(source[vertex]);
+
+		};
+
+		copyStream(object.positions, chunk->positions);
+		copyStream(object.normals, chunk->normals);
+		copyStream(object.uvs, chunk->uvs);
+		copyStream(object.uvs2, chunk->uvs2);
+		copyStream(object.tangents, chunk->tangents);
+
+		// Groups keep their original order, with each chunk holding only the groups it received triangles for.
+		std::vector<std::shared_ptr<obj_group_t>> chunkGroups(object.groups.size());
+		for(auto t = first; t < last; ++t)
+		{
+			const auto &triangle = triangles[t];
+			auto &chunkGroup = chunkGroups[triangle.group];
+
+			if(!chunkGroup)
+			{
+				const auto &group = *object.groups[triangle.group];
+				chunkGroup = std::make_shared<obj_group_t>();
+				chunkGroup->materialId = group.materialId;
+				chunkGroup->name = group.name;
+				chunkGroup->materialName = group.materialName;
+				chunkGroup->smoothing = group.smoothing;
+
+			}
+
+			chunkGroup->faces.push_back({ static_cast<obj_index_t>(remap[triangle.face.a]), static_cast<obj_index_t>(remap[triangle.face.b]), static_cast<obj_index_t>(remap[triangle.face.c]) });
+
+		}
+
+		for(const auto &chunkGroup : chunkGroups) if(chunkGroup) chunk->groups.push_back(chunkGroup);
+		chunks.push_back(chunk);
+
+		for(auto vertex : chunkVertices) remap[vertex] = -1;
+		chunkVertices.clear();
+		first = last;
+
+	}
+
+	return chunks;
+
+}
+
+// Replaces every object exceeding the 16-bit vertex limit with its chunks, in place.  Returns the number of objects split.
+std::size_t SplitObjects(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	if(!createIndexedGeometry) return 0;
+
+	std::size_t splitObjects = 0, addedObjects = 0;
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			std::vector<std::shared_ptr<obj_object_t>> objects;
+
+			for(const auto &object : objState->objects)
+			{
+				if(object->positions.size() <= maxIndexableVertices)
+				{
+					objects.push_back(object);
+					continue;
+
+				}
+
+				auto chunks = SplitObject(*object);
+				++splitObjects;
+				addedObjects += chunks.size() - 1;
+
+				if(logWarnings) Log() << "WARNING: [" << asset->name << "] Split an object with " << object->positions.size() << " vertices in to " << chunks.size() << " chunks of at most " << maxIndexableVertices << " vertices." << std::endl;
+				objects.insert(objects.end(), chunks.begin(), chunks.end());
+
+			}
+
+			objState->objects.swap(objects);
+
+		}
+
+	}
+
+	return splitObjects;
+
+}
+
+// Computes object and group bounds once geometry is final, so that stages which move or merge vertices are accounted for.
+void ComputeBounds(const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				const auto &positions = object->positions;
+				object->bounds = MakeBounds(positions.size(), [&positions](std::size_t i) { return positions[i]; });
+
+				for(const auto &group : object->groups)
+				{
+					const auto *indices = reinterpret_cast<const obj_index_t*>(group->faces.data());
+					group->bounds = MakeBounds(group->faces.size() * 3, [&positions, indices](std::size_t i) { return positions[indices[i]]; });
+
+				}
+
+			}
+
+		}
+
+	}
+
+}
+
+struct bvh_build_item_t
+{
+	obj_vector3_t min, max, centroid;
+	bvh_primitive_t primitive;
+
+};
+
+struct bvh_build_node_t
+{
+	obj_vector3_t min, max;
+	std::size_t first, count;
+	std::uint8_t axis = 0;
+	std::unique_ptr<bvh_build_node_t> children[2];
+
+};
+
+// Builds a subtree over items [first, first + count) using binned surface area heuristic splits, reordering the items in place.
+// Large subtrees build their first child on another thread, which is safe as sibling subtrees only touch disjoint item ranges.
+std::unique_ptr<bvh_build_node_t> BuildBVHNode(std::vector<bvh_build_item_t> &items, std::size_t first, std::size_t count, int parallelDepth)
+{
+	static const std::size_t BIN_COUNT = 16, MAX_LEAF_PRIMITIVES = 8, PARALLEL_PRIMITIVES = 4096;
+	static const float TRAVERSAL_COST = 1.0f;
+
+	auto grow = [](obj_vector3_t &min, obj_vector3_t &max, const obj_vector3_t &pointMin, const obj_vector3_t &pointMax)
+	{
+		min = { std::min(min.x, pointMin.x), std::min(min.y, pointMin.y), std::min(min.z, pointMin.z) };
+		max = { std::max(max.x, pointMax.x), std::max(max.y, pointMax.y), std::max(max.z, pointMax.z) };
+
+	};
+
+	auto area = [](const obj_vector3_t &min, const obj_vector3_t &max)
+	{
+		float dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z;
+		return 2.0f * (dx * dy + dy * dz + dz * dx);
+
+	};
+
+	auto component = [](const obj_vector3_t &vector, int axis) { return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z); };
+
+	auto node = std::unique_ptr<bvh_build_node_t>(new bvh_build_node_t());
+	node->first = first;
+	node->count = count;
+	node->min = node->max = items[first].min;
+
+	obj_vector3_t centroidMin = items[first].centroid, centroidMax = items[first].centroid;
+	for(std::size_t i = first; i < first + count; ++i)
+	{
+		grow(node->min, node->max, items[i].min, items[i].max);
+		grow(centroidMin, centroidMax, items[i].centroid, items[i].centroid);
+
+	}
+
+	if(count <= 2) return node;
+
+	// Split Along The Axis Of Greatest Centroid Extent
+	obj_vector3_t extent = { centroidMax.x - centroidMin.x, centroidMax.y - centroidMin.y, centroidMax.z - centroidMin.z };
+	int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+	float axisMin = component(centroidMin, axis), axisExtent = component(extent, axis);
+
+	std::size_t splitIndex;
+	if(axisExtent <= 0.0f)
+	{
+		// Coincident centroids cannot be separated spatially, so oversized leaves are split evenly by count.
+		if(count <= MAX_LEAF_PRIMITIVES) return node;
+		splitIndex = first + count / 2;
+
+	}
+	else
+	{
+		struct bin_t
+		{
+			obj_vector3_t min, max;
+			std::size_t count = 0;
+
+		} bins[BIN_COUNT];
+
+		auto binIndex = [&](const bvh_build_item_t &item)
+		{
+			auto index = static_cast<std::size_t>(BIN_COUNT * ((component(item.centroid, axis) - axisMin) / axisExtent));
+			return std::min(index, BIN_COUNT - 1);
+
+		};
+
+		for(std::size_t i = first; i < first + count; ++i)
+		{
+			auto &bin = bins[binIndex(items[i])];
+			if(bin.count++ == 0)
+			{
+				bin.min = items[i].min;
+				bin.max = items[i].max;
+
+			}
+			else
+			{
+				grow(bin.min, bin.max, items[i].min, items[i].max);
+
+			}
+
+		}
+
+		// Evaluate The Cost Of Splitting After Each Bin
+		float rightAreas[BIN_COUNT];
+		std::size_t rightCounts[BIN_COUNT];
+		obj_vector3_t min, max;
+		std::size_t accumulated = 0;
+
+		for(std::size_t i = BIN_COUNT - 1; i > 0; --i)
+		{
+			if(bins[i].count > 0)
+			{
+				if(accumulated == 0)
+				{
+					min = bins[i].min;
+					max = bins[i].max;
+
+				}
+				else
+				{
+					grow(min, max, bins[i].min, bins[i].max);
+
+				}
+
+				accumulated += bins[i].count;
+
+			}
+
+			rightCounts[i] = accumulated;
+			rightAreas[i] = accumulated > 0 ? area(min, max) : 0.0f;
+
+		}
+
+		float bestCost = std::numeric_limits<float>::max();
+		std::size_t bestBin = 0;
+		accumulated = 0;
+
+		for(std::size_t i = 0; i < BIN_COUNT - 1; ++i)
+		{
+			if(bins[i].count > 0)
+			{
+				if(accumulated == 0)
+				{
+					min = bins[i].min;
+					max = bins[i].max;
+
+				}
+				else
+				{
+					grow(min, max, bins[i].min, bins[i].max);
+
+				}
+
+				accumulated += bins[i].count;
+
+			}
+
+			if(accumulated == 0 || rightCounts[i + 1] == 0) continue;
+
+			float cost = area(min, max) * accumulated + rightAreas[i + 1] * rightCounts[i + 1];
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = i;
+
+			}
+
+		}
+
+		float nodeArea = area(node->min, node->max);
+		float splitCost = TRAVERSAL_COST + (nodeArea > 0.0f ? bestCost / nodeArea : 0.0f);
+		if(count <= MAX_LEAF_PRIMITIVES && splitCost >= static_cast<float>(count)) return node;
+
+		auto middle = std::partition(items.begin() + first, items.begin() + first + count, [&](const bvh_build_item_t &item) { return binIndex(item) <= bestBin; });
+		splitIndex = static_cast<std::size_t>(middle - items.begin());
+
+	}
+
+	node->axis = static_cast<std::uint8_t>(axis);
+
+	if(parallelDepth > 0 && count >= PARALLEL_PRIMITIVES)
+	{
+		auto firstChild = std::async(std::launch::async, BuildBVHNode, std::ref(items), first, splitIndex - first, parallelDepth - 1);
+		node->children[1] = BuildBVHNode(items, splitIndex, first + count - splitIndex, parallelDepth - 1);
+		node->children[0] = firstChild.get();
+
+	}
+	else
+	{
+		node->children[0] = BuildBVHNode(items, first, splitIndex - first, 0);
+		node->children[1] = BuildBVHNode(items, splitIndex, first + count - splitIndex, 0);
+
+	}
+
+	return node;
+
+}
+
+void FlattenBVHNode(const bvh_build_node_t &buildNode, bom_bvh_t &bvh)
+{
+	auto nodeIndex = bvh.nodes.size();
+	bvh.nodes.push_back(bvh_node_t());
+	bvh.nodes[nodeIndex].min = buildNode.min;
+	bvh.nodes[nodeIndex].max = buildNode.max;
+	bvh.nodes[nodeIndex].axis = buildNode.axis;
+	bvh.nodes[nodeIndex].padding = 0;
+
+	if(!buildNode.children[0])
+	{
+		bvh.nodes[nodeIndex].offset = buildNode.first;
+		bvh.nodes[nodeIndex].primitiveCount = buildNode.count;
+		return;
+
+	}
+
+	bvh.nodes[nodeIndex].primitiveCount = 0;
+	FlattenBVHNode(*buildNode.children[0], bvh);
+	bvh.nodes[nodeIndex].offset = bvh.nodes.size();
+	FlattenBVHNode(*buildNode.children[1], bvh);
+
+}
+
+// Builds a BVH over the bounds of every group, or every triangle of groups with at least bvhTriangleThreshold triangles, requires computed bounds.
+bool BuildBVH(const std::vector<std::shared_ptr<bom_asset_t>> &assets, bom_bvh_t &bvh)
+{
+	std::vector<bvh_build_item_t> items;
+	std::uint32_t objectIndex = 0;
+
+	auto addItem = [&items](const obj_vector3_t &min, const obj_vector3_t &max, const bvh_primitive_t &primitive)
+	{
+		bvh_build_item_t item;
+		item.min = min;
+		item.max = max;
+		item.centroid = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+		item.primitive = primitive;
+		items.push_back(item);
+
+	};
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				bool hasFaces = false;
+
+				for(std::uint32_t groupIndex = 0; groupIndex < object->groups.size(); ++groupIndex)
+				{
+					const auto &group = object->groups[groupIndex];
+					if(group->faces.empty()) continue;
+					hasFaces = true;
+
+					if(bvhTriangleThreshold == 0 || group->faces.size() < bvhTriangleThreshold)
+					{
+						addItem(group->bounds.min, group->bounds.max, { objectIndex, groupIndex, 0, static_cast<std::uint32_t>(group->faces.size()) });
+						continue;
+
+					}
+
+					for(std::uint32_t triangleIndex = 0; triangleIndex < group->faces.size(); ++triangleIndex)
+					{
+						const auto &face = group->faces[triangleIndex];
+						const auto &a = object->positions[face.a], &b = object->positions[face.b], &c = object->positions[face.c];
+						obj_vector3_t min = { std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }), std::min({ a.z, b.z, c.z }) };
+						obj_vector3_t max = { std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }), std::max({ a.z, b.z, c.z }) };
+						addItem(min, max, { objectIndex, groupIndex, triangleIndex, 1 });
+
+					}
+
+				}
+
+				// Non-indexed geometry is referenced as a whole object.
+				if(!hasFaces && !object->positions.empty()) addItem(object->bounds.min, object->bounds.max, { objectIndex, std::numeric_limits<std::uint32_t>::max(), 0, static_cast<std::uint32_t>(object->positions.size() / 3) });
+
+				++objectIndex;
+
+			}
+
+		}
+
+	}
+
+	bvh.nodes.clear();
+	bvh.primitives.clear();
+	if(items.empty()) return false;
+
+	int parallelDepth = 0;
+	while((1u << parallelDepth) < ConversionThreadCount()) ++parallelDepth;
+
+	auto root = BuildBVHNode(items, 0, items.size(), parallelDepth);
+	FlattenBVHNode(*root, bvh);
+
+	bvh.primitives.reserve(items.size());
+	for(const auto &item : items) bvh.primitives.push_back(item.primitive);
+
+	Log() << "Built BVH with " << bvh.nodes.size() << " node(s) over " << bvh.primitives.size() << " primitive(s)." << std::endl;
+	return true;
+
+}
+
+bool VerifyBOM(const std::vector<std::shared_ptr<bom_asset_t>> &assets, const std::string &bomFilePath, const bom_bvh_t *bvh = nullptr)
+{
+	Log() << "Verifying BOM '" << bomFilePath << "'..." << std::endl;
+
+	BomReader reader;
+	auto loadStart = std::chrono::steady_clock::now();
+	if(!reader.Load(bomFilePath))
+	{
+		if(logErrors) Log() << "ERROR: [" << bomFilePath << "] " << reader.GetError() << std::endl;
+		return false;
+
+	}
+
+	auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+	auto fail = [&](const std::string &message)
+	{
+		if(logErrors) Log() << "ERROR: [" << bomFilePath << "] Round-trip mismatch: " << message << std::endl;
+		return false;
+
+	};
+
+	auto sameData = [](const auto &span, const auto &values)
+	{
+		return span.bytes() == values.size() * sizeof(values[0]) && (values.empty() || std::memcmp(span.data, values.data(), span.bytes()) == 0);
+
+	};
+
+	auto sameIndices = [](const auto &span, const std::vector<obj_face3_t> &faces)
+	{
+		if(span.size != faces.size() * 3) return false;
+
+		for(std::size_t i = 0; i < faces.size(); ++i)
+		{
+			if(span[i * 3] != faces[i].a || span[i * 3 + 1] != faces[i].b || span[i * 3 + 2] != faces[i].c) return false;
+
+		}
+
+		return true;
+
+	};
+
+	// Material Library
+	std::map<std::uint32_t, std::uint32_t> materialIndices;
+	std::size_t materialIndex = 0;
+	for(const auto &material : CollectLibraryMaterials())
+	{
+		if(materialIndex >= reader.materials.size()) return fail("material count");
+
+		const auto &readMaterial = reader.materials[materialIndex];
+		if(readMaterial.attributes != WrittenAttributes(*material) || readMaterial.name != material->name) return fail("material '" + material->name + "'");
+
+		materialIndices[material->id] = materialIndex++;
+
+	}
+
+	if(materialIndex != reader.materials.size()) return fail("material count");
+
+	// Assets
+	if(reader.assets.size() != assets.size()) return fail("asset count");
+
+	for(std::size_t assetIndex = 0; assetIndex < assets.size(); ++assetIndex)
+	{
+		const auto &asset = assets[assetIndex];
+		const auto &readAsset = reader.assets[assetIndex];
+		if(readAsset.name != asset->name) return fail("asset name '" + asset->name + "'");
+
+		std::size_t objectIndex = 0;
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				if(objectIndex >= readAsset.objects.size()) return fail("object count in asset '" + asset->name + "'");
+
+				const auto &readObject = readAsset.objects[objectIndex++];
+				if(readObject.vertexCount != object->positions.size() || !sameData(readObject.positions, object->positions)) return fail("vertex positions in asset '" + asset->name + "'");
+				if(!sameData(readObject.normals, object->normals)) return fail("vertex normals in asset '" + asset->name + "'");
+				if(!sameData(readObject.uvs, object->uvs) || !sameData(readObject.uvs2, object->uvs2)) return fail("vertex UVs in asset '" + asset->name + "'");
+				if(!sameData(readObject.tangents, object->tangents)) return fail("vertex tangents in asset '" + asset->name + "'");
+				if(readObject.groups.size() != object->groups.size()) return fail("group count in asset '" + asset->name + "'");
+				if((readObject.attributes & BitmaskFlag(ObjectDataAttribute::BOUNDS)) && std::memcmp(&readObject.bounds, &object->bounds, sizeof(object->bounds)) != 0) return fail("object bounds in asset '" + asset->name + "'");
+
+				for(std::size_t groupIndex = 0; groupIndex < object->groups.size(); ++groupIndex)
+				{
+					const auto &group = object->groups[groupIndex];
+					const auto &readGroup = readObject.groups[groupIndex];
+					if(readGroup.name != group->name) return fail("group name '" + group->name + "'");
+					if(!object->positions.empty() && !sameIndices(readGroup.indices, group->faces)) return fail("indices in group '" + group->name + "'");
+					if((readGroup.attributes & BitmaskFlag(GroupDataAttribute::BOUNDS)) && std::memcmp(&readGroup.bounds, &group->bounds, sizeof(group->bounds)) != 0) return fail("bounds in group '" + group->name + "'");
+
+					// Groups of objects without geometry carry only their name.
+					if(!object->positions.empty() && (readGroup.attributes & BitmaskFlag(GroupDataAttribute::MATERIAL)))
+					{
+						auto expectedIndex = materialIndices.find(group->materialId);
+						if(expectedIndex == materialIndices.end() || expectedIndex->second != readGroup.materialId) return fail("material ID in group '" + group->name + "'");
+
+					}
+
+				}
+
+			}
+
+		}
+
+		if(objectIndex != readAsset.objects.size()) return fail("object count in asset '" + asset->name + "'");
+
+	}
+
+	// Scene BVH
+	auto sameBVH = bvh && !bvh->nodes.empty() ? sameData(reader.bvhNodes, bvh->nodes) && sameData(reader.bvhPrimitives, bvh->primitives) : reader.bvhNodes.empty();
+	if(!sameBVH) return fail("BVH");
+
+	Log() << "Verified BOM '" << bomFilePath << "' (loaded in " << loadTime << " ms)." << std::endl;
+
+	if(benchmarkIterations > 0)
+	{
+		// Load-time Benchmark
+		// Parses the in-memory file repeatedly so that only parsing cost is measured, independent of disk caching.
+		std::ifstream bomFile(bomFilePath, std::ios::in | std::ios::binary);
+		std::vector<char> buffer((std::istreambuf_iterator<char>(bomFile)), std::istreambuf_iterator<char>());
+		double minTime = 0.0, totalTime = 0.0;
+
+		for(int i = 0; i < benchmarkIterations; ++i)
+		{
+			auto parseStart = std::chrono::steady_clock::now();
+			reader.Parse(buffer.data(), buffer.size());
+			auto parseTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseStart).count();
+
+			totalTime += parseTime;
+			if(i == 0 || parseTime < minTime) minTime = parseTime;
+
+		}
+
+		auto throughput = minTime > 0.0 ? (buffer.size() / (1024.0 * 1024.0)) / (minTime / 1000.0) : 0.0;
+		Log() << "Benchmark: " << benchmarkIterations << " parses of " << buffer.size() << " bytes, min " << minTime << " ms, mean " << (totalTime / benchmarkIterations) << " ms (" << throughput << " MB/s)." << std::endl;
+
+	}
+
+	return true;
+
+}
+
+// Texture References
+// A texture referenced by one or more material maps, resolved relative to the MTL file that references it.
+struct texture_reference_t
+{
+	std::string path, resolvedPath;
+	std::vector<std::string> referencedBy;
+	bool found = false;
+	std::uint64_t size = 0, contentHash = 0;
+
+};
+
+// Texture hashes shared across conversions, keyed by resolved path and reused while the size and modification time of the file are unchanged.
+struct texture_hash_t
+{
+	std::uint64_t size = 0, contentHash = 0;
+	std::int64_t modifiedTime = 0;
+
+};
+
+std::unordered_map<std::string, texture_hash_t> textureHashCache;
+std::mutex textureHashCacheMutex;
+
+// Returns the size and modification time, in nanoseconds where the platform provides them, of a file.
+bool GetFileStamp(const std::string &filePath, std::uint64_t &size, std::int64_t &modifiedTime)
+{
+#ifdef _WIN32
+	struct _stat64 status;
+	if(_stat64(filePath.c_str(), &status) != 0) return false;
+	modifiedTime = static_cast<std::int64_t>(status.st_mtime) * 1000000000;
+#else
+	struct stat status;
+	if(stat(filePath.c_str(), &status) != 0 || !S_ISREG(status.st_mode)) return false;
+#if defined(__linux__)
+	modifiedTime = static_cast<std::int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+#else
+	modifiedTime = static_cast<std::int64_t>(status.st_mtime) * 1000000000;
+#endif
+#endif
+
+	size = static_cast<std::uint64_t>(status.st_size);
+	return true;
+
+}
+
+// Collects the unique textures referenced by the material libraries of the current conversion, in order of first reference.
+std::vector<texture_reference_t> CollectTextures()
+{
+	std::vector<texture_reference_t> textures;
+	std::unordered_map<std::string, std::size_t> textureIndices;
+
+	for(const auto &mtlState : mtlStates)
+	{
+		auto directory = mtlState->filePath.substr(0, mtlState->filePath.find_last_of("/\\") + 1);
+
+		for(const auto &material : mtlState->materials)
+		{
+			for(auto mapMember : MTL_MAPS)
+			{
+				const auto *map = &((*material.second).*mapMember);
+				if(!(map->attributes & BitmaskFlag(MapDataAttribute::PATH)) || map->path.empty()) continue;
+
+				bool isAbsolute = map->path[0] == '/' || map->path[0] == '\\' || (map->path.size() > 1 && map->path[1] == ':');
+				auto resolvedPath = ResolvePath(isAbsolute ? map->path : directory + map->path);
+
+				auto textureIndex = textureIndices.insert(std::make_pair(resolvedPath, textures.size()));
+				if(textureIndex.second)
+				{
+					texture_reference_t texture;
+					texture.path = map->path;
+					texture.resolvedPath = resolvedPath;
+					textures.push_back(texture);
+
+				}
+
+				textures[textureIndex.first->second].referencedBy.push_back(mtlState->name + ":" + material.second->name);
+
+			}
+
+		}
+
+	}
+
+	return textures;
+
+}
+
+// Reads every texture to record its size and content hash, spreading the files over up to threadCount threads.
+void HashTextures(std::vector<texture_reference_t> &textures, unsigned int threadCount)
+{
+	const std::size_t taskCount = std::min<std::size_t>(threadCount, textures.size());
+	std::vector<std::future<void>> tasks;
+
+	for(std::size_t task = 0; task < taskCount; ++task)
+	{
+		tasks.push_back(std::async(std::launch::async, [&textures, task, taskCount]()
+		{
+			std::string content;
+			for(auto i = task; i < textures.size(); i += taskCount)
+			{
+				auto &texture = textures[i];
+
+				texture_hash_t stamp;
+				if(!GetFileStamp(texture.resolvedPath, stamp.size, stamp.modifiedTime)) continue;
+
+				{
+					std::lock_guard<std::mutex> lock(textureHashCacheMutex);
+					auto cachedHash = textureHashCache.find(texture.resolvedPath);
+					if(cachedHash != textureHashCache.end() && cachedHash->second.size == stamp.size && cachedHash->second.modifiedTime == stamp.modifiedTime)
+					{
+						texture.found = true;
+						texture.size = cachedHash->second.size;
+						texture.contentHash = cachedHash->second.contentHash;
+						continue;
+
+					}
+
+				}
+
+				texture.found = ReadFile(texture.resolvedPath, content);
+				if(!texture.found) continue;
+
+				texture.size = content.size();
+				texture.contentHash = HashXXH64(content.data(), content.size());
+
+				if(texture.size == stamp.size)
+				{
+					stamp.contentHash = texture.contentHash;
+					std::lock_guard<std::mutex> lock(textureHashCacheMutex);
+					textureHashCache[texture.resolvedPath] = stamp;
+
+				}
+
+			}
+
+		}));
+
+	}
+
+	for(auto &task : tasks) task.get();
+
+}
+
+// Dependency Manifest Syntax
+// One file per line: <size> <xxh64> <path>, starting with the BOM itself followed by every texture it references.
+bool WriteDependencies(const std::string &bomFilePath, const bom_file_digest_t &digest, const std::vector<texture_reference_t> &textures)
+{
+	auto dependencyFilePath = bomFilePath + ".deps";
+
+	std::ofstream dependencyFile(dependencyFilePath, std::ios::out | std::ios::binary);
+	if(!dependencyFile.is_open()) return false;
+
+	auto writeEntry = [&dependencyFile](std::uint64_t size, std::uint64_t contentHash, const std::string &path)
+	{
+		dependencyFile << size << " " << std::hex << std::setw(16) << std::setfill('0') << contentHash << std::dec << std::setfill(' ') << " " << std::quoted(path) << "\n";
+
+	};
+
+	dependencyFile << "# <size> <xxh64> <path>\n";
+	writeEntry(digest.size, digest.hash, ResolvePath(bomFilePath));
+	for(const auto &texture : textures) if(texture.found) writeEntry(texture.size, texture.contentHash, texture.resolvedPath);
+
+	Log() << "Wrote dependency manifest '" << dependencyFilePath << "'." << std::endl;
+	return dependencyFile.good();
+
+}
+
+// Section Manifest Syntax
+// The XXH64 of the BOM and of the conversion options, followed by each input as a quoted path and one line per section: <xxh64> <object count>
+std::uint64_t HashConversionOptions()
+{
+	// Options that change the objects written for a section, the remaining ones are applied to reused objects alike.
+	std::ostringstream options;
+	options << createIndexedGeometry << readNormals << readUVs << readUV2s << flipV << zUpToYUp << normalizeNormals << mergeGroups << generateNormals << angleWeightedNormals << generateTangents;
+	options << " " << unitScale << " " << weldTolerance << " " << creaseAngle;
+
+	const auto content = options.str();
+	return HashXXH64(content.data(), content.size());
+
+}
+
+bool WriteSections(const std::string &bomFilePath, const bom_file_digest_t &digest, const std::vector<std::shared_ptr<bom_asset_t>> &assets)
+{
+	auto sectionFilePath = bomFilePath + ".sections";
+
+	std::ofstream sectionFile(sectionFilePath, std::ios::out | std::ios::binary);
+	if(!sectionFile.is_open()) return false;
+
+	auto writeHash = [&sectionFile](std::uint64_t hash) { sectionFile << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << std::setfill(' '); };
+
+	sectionFile << "# <bom xxh64> <options xxh64>\n";
+	writeHash(digest.hash);
+	sectionFile << " ";
+	writeHash(HashConversionOptions());
+	sectionFile << "\n# <xxh64> <object count>\n";
+
+	for(const auto &asset : assets)
+	{
+		sectionFile << std::quoted(asset->filePath) << "\n";
+
+		for(const auto &objState : asset->objStates)
+		{
+			std::vector<std::size_t> objectCounts(objState->sectionFingerprints.size());
+			for(const auto &object : objState->objects) ++objectCounts[object->section];
+
+			for(std::size_t section = 0; section < objectCounts.size(); ++section)
+			{
+				writeHash(objState->sectionFingerprints[section]);
+				sectionFile << " " << objectCounts[section] << "\n";
+
+			}
+
+		}
+
+	}
+
+	Log() << "Wrote section manifest '" << sectionFilePath << "'." << std::endl;
+	return sectionFile.good();
+
+}
+
+// Loads the sections of the previous conversion to a BOM, failing when there are none or they no longer match the BOM or the options.
+bool ReadSections(const std::string &bomFilePath, bom_previous_t &previous)
+{
+	auto sectionFilePath = bomFilePath + ".sections";
+
+	std::ifstream sectionFile(sectionFilePath, std::ios::in | std::ios::binary);
+	if(!sectionFile.is_open()) return false;
+
+	std::string line;
+	std::uint64_t bomHash = 0, optionsHash = 0;
+	bool hasHeader = false;
+	std::unordered_map<std::uint64_t, bom_previous_section_t> *sections = nullptr;
+	std::size_t objectCount = 0;
+
+	auto mismatch = [&sectionFilePath](const std::string &reason)
+	{
+		Log() << "Ignoring section manifest '" << sectionFilePath << "', " << reason << "." << std::endl;
+		return false;
+
+	};
+
+	while(std::getline(sectionFile, line))
+	{
+		if(line.empty() || line[0] == '#') continue;
+
+		std::istringstream iss(line);
+		if(!hasHeader)
+		{
+			if(!(iss >> std::hex >> bomHash >> optionsHash)) return mismatch("its header could not be parsed");
+			hasHeader = true;
+
+		}
+		else if(line[0] == '"')
+		{
+			std::string objFilePath;
+			if(!(iss >> std::quoted(objFilePath))) return mismatch("an input path could not be parsed");
+			sections = &previous.assets[objFilePath];
+
+		}
+		else
+		{
+			std::uint64_t fingerprint;
+			std::size_t sectionObjects;
+			if(!sections || !(iss >> std::hex >> fingerprint >> std::dec >> sectionObjects) || sectionObjects == 0) return mismatch("a section could not be parsed");
+
+			sections->insert(std::make_pair(fingerprint, bom_previous_section_t { objectCount, sectionObjects }));
+			objectCount += sectionObjects;
+
+		}
+
+	}
+
+	if(optionsHash != HashConversionOptions()) return mismatch("the conversion options changed");
+
+	if(!ReadFile(bomFilePath, previous.content) || HashXXH64(previous.content.data(), previous.content.size()) != bomHash) return mismatch("the BOM changed since");
+	if(!previous.reader.Parse(previous.content.data(), previous.content.size())) return mismatch("the BOM could not be read: " + previous.reader.GetError());
+
+	for(const auto &asset : previous.reader.assets)
+	{
+		for(const auto &object : asset.objects) previous.objects.push_back(&object);
+
+	}
+
+	if(previous.objects.size() != objectCount) return mismatch("its sections do not match the objects of the BOM");
+
+	Log() << "Read section manifest '" << sectionFilePath << "'." << std::endl;
+	return true;
+
+}
+
+struct bom_stats_t
+{
+	std::size_t jobs = 0, failedJobs = 0, inputs = 0, failedInputs = 0, objects = 0, groups = 0, materials = 0, weldedVertices = 0, textures = 0, missingTextures = 0, mergedObjects = 0, mergedGroups = 0, mergedMaterials = 0;
+	std::uint64_t vertices = 0, triangles = 0, bytes = 0;
+	double seconds = 0.0;
+
+	bom_stats_t &operator+=(const bom_stats_t &other)
+	{
+		jobs += other.jobs;
+		failedJobs += other.failedJobs;
+		inputs += other.inputs;
+		failedInputs += other.failedInputs;
+		objects += other.objects;
+		groups += other.groups;
+		materials += other.materials;
+		weldedVertices += other.weldedVertices;
+		textures += other.textures;
+		missingTextures += other.missingTextures;
+		mergedObjects += other.mergedObjects;
+		mergedGroups += other.mergedGroups;
+		mergedMaterials += other.mergedMaterials;
+		vertices += other.vertices;
+		triangles += other.triangles;
+		bytes += other.bytes;
+		seconds += other.seconds;
+		return *this;
+
+	}
+
+};
+
+struct bom_job_t
+{
+	std::string bomFilePath;
+	std::vector<std::string> objFilePaths;
+
+};
+
+bool ConvertBOM(const std::string &bomFilePath, const std::vector<std::string> &objFilePaths, bom_stats_t &stats)
+{
+	auto startTime = std::chrono::steady_clock::now();
+
+	mtlStates.clear();
+	maxMaterialId = 0;
+
+	std::vector<std::shared_ptr<bom_asset_t>> assets;
+
+	// Sections unchanged since the previous conversion are taken from its BOM, which is only held until all inputs are read.
+	std::unique_ptr<bom_previous_t> previous;
+	if(incrementalConversion)
+	{
+		previous.reset(new bom_previous_t());
+		if(!ReadSections(bomFilePath, *previous)) previous.reset();
+
+	}
+
+	// Inputs are read ahead of the parser, see ReadOBJ, with later inputs prefetched in the background while earlier ones are parsed.
+	for(const auto &objFilePath : objFilePaths) PrefetchFile(objFilePath);
+
+	for(const auto &objFilePath : objFilePaths)
+	{
+		// Construct Asset For Each OBJ File
+		// TODO:: Add Command Line Options To Allow Asset Construction Consisting Of Multiple OBJ Files
+		auto asset = std::make_shared<bom_asset_t>();
+		asset->name = objFilePath.substr(objFilePath.find_last_of("/\\") + 1);
+		asset->filePath = objFilePath;
+
+		if(ReadOBJ(asset, objFilePath, previous.get())) assets.push_back(asset);
+		else ++stats.failedInputs;
+
+	}
+
+	previous.reset();
+
+	if(mergeMaterials) stats.mergedMaterials += MergeMaterials(assets);
+
+	// Texture files are read and hashed in the background while geometry is processed and written.
+	std::vector<texture_reference_t> textures;
+	std::future<void> texturesHashed;
+	if(checkTextures || writeDependencies)
+	{
+		textures = CollectTextures();
+		texturesHashed = std::async(std::launch::async, HashTextures, std::ref(textures), ConversionThreadCount());
+
+	}
+
+	if(mergeObjectVertices > 0 || mergeGroups)
+	{
+		// Draw Call Batching
+		auto mergedObjects = mergeObjectVertices > 0 ? MergeObjects(assets, mergeObjectVertices) : 0;
+		auto mergedGroups = mergeGroups ? MergeGroups(assets) : 0;
+		Log() << "Merged " << mergedObjects << " object(s) and " << mergedGroups << " group(s)." << std::endl;
+
+		stats.mergedObjects += mergedObjects;
+		stats.mergedGroups += mergedGroups;
+
+	}
+
+	if(flipV || zUpToYUp || unitScale != 1.0f || normalizeNormals) TransformVertices(assets);
+
+	if(weldTolerance >= 0.0f) stats.weldedVertices += WeldVertices(assets, weldTolerance);
+
+	if(generateNormals) GenerateNormals(assets);
+	if(generateTangents) GenerateTangents(assets);
+
+	SplitObjects(assets);
+
+	if(computeBounds || buildBVH) ComputeBounds(assets);
+
+	bom_bvh_t bvh;
+	if(buildBVH) BuildBVH(assets, bvh);
+
+	bom_file_digest_t digest;
+	bool success = WriteBOM(assets, bomFilePath, &bvh, digest);
+	if(!success)
+	{
+		if(logErrors) Log() << "ERROR: Failed to write BOM file '" << bomFilePath << "'" << std::endl;
+
+	}
+	else if(verifyOutput)
+	{
+		success = VerifyBOM(assets, bomFilePath, &bvh);
+
+	}
+
+	if(success && incrementalConversion && !WriteSections(bomFilePath, digest, assets))
+	{
+		if(logErrors) Log() << "ERROR: Failed to write section manifest for BOM file '" << bomFilePath << "'" << std::endl;
+		success = false;
+
+	}
+
+	if(texturesHashed.valid())
+	{
+		texturesHashed.get();
+
+		std::size_t missingTextures = 0;
+		for(const auto &texture : textures)
+		{
+			if(texture.found) continue;
+
+			++missingTextures;
+			if(logWarnings) Log() << "WARNING: [" << texture.referencedBy.front() << "] Texture '" << texture.path << "' not found at '" << texture.resolvedPath << "'" << (texture.referencedBy.size() > 1 ? " (and " + std::to_string(texture.referencedBy.size() - 1) + " other reference(s))" : "") << "." << std::endl;
+
+		}
+
+		Log() << "Resolved " << textures.size() << " texture(s), " << missingTextures << " missing." << std::endl;
+		stats.textures += textures.size();
+		stats.missingTextures += missingTextures;
+
+		if(success && writeDependencies && !WriteDependencies(bomFilePath, digest, textures))
+		{
+			if(logErrors) Log() << "ERROR: Failed to write dependency manifest for BOM file '" << bomFilePath << "'" << std::endl;
+			success = false;
+
+		}
+
+	}
+
+	// Statistics
+	++stats.jobs;
+	if(!success) ++stats.failedJobs;
+	stats.inputs += objFilePaths.size();
+	for(const auto &mtlState : mtlStates) stats.materials += mtlState->materials.size();
+
+	for(const auto &asset : assets)
+	{
+		for(const auto &objState : asset->objStates)
+		{
+			for(const auto &object : objState->objects)
+			{
+				++stats.objects;
+				stats.groups += object->groups.size();
+				stats.vertices += object->positions.size();
+
+				if(createIndexedGeometry) for(const auto &group : object->groups) stats.triangles += group->faces.size();
+				else stats.triangles += object->positions.size() / 3;
+
+			}
+
+		}
+
+	}
+
+	if(success)
+	{
+		std::ifstream bomFile(bomFilePath, std::ios::in | std::ios::binary | std::ios::ate);
+		if(bomFile.is_open()) stats.bytes += static_cast<std::uint64_t>(bomFile.tellg());
+
+	}
+
+	stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	mtlStates.clear();
+	return success;
+
+}
+
+// Manifest Syntax
+// One job per line: <output.bom> <input1.obj> [input2.obj] [...inputN.obj]
+// Paths containing whitespace may be enclosed in double quotes, empty lines and lines beginning with '#' are skipped.
+// Parses a single job line, returning false for empty lines and comments.
+bool ParseJob(const std::string &line, bom_job_t &job)
+{
+	std::istringstream iss(line);
+	if(!(iss >> std::quoted(job.bomFilePath)) || job.bomFilePath[0] == '#') return false;
+
+	std::string objFilePath;
+	while(iss >> std::quoted(objFilePath)) job.objFilePaths.push_back(objFilePath);
+	return true;
+
+}
+
+bool ReadManifest(const std::string &manifestFilePath, std::vector<bom_job_t> &jobs)
+{
+	std::ifstream manifestFile(manifestFilePath);
+	if(!manifestFile.is_open()) return false;
+
+	std::string line;
+	int lineNo = 0;
+
+	while(std::getline(manifestFile, line))
+	{
+		++lineNo;
+
+		bom_job_t job;
+		if(!ParseJob(line, job)) continue;
+
+		if(job.objFilePaths.empty())
+		{
+			if(logWarnings) Log() << "WARNING: [" << manifestFilePath << ":" << lineNo << "] No OBJ file path(s) provided as input for '" << job.bomFilePath << "', job will be skipped." << std::endl;
+			continue;
+
+		}
+
+		jobs.push_back(job);
+
+	}
+
+	return true;
+
+}
+
+void PrintStats(const bom_stats_t &stats, double wallSeconds)
+{
+	Log() << "Converted " << (stats.jobs - stats.failedJobs) << "/" << stats.jobs << " BOM file(s) from " << (stats.inputs - stats.failedInputs) << "/" << stats.inputs << " OBJ file(s) in " << wallSeconds << " s (" << stats.seconds << " s of conversion time)." << std::endl;
+	Log() << "  Objects: " << stats.objects << " (" << stats.mergedObjects << " merged), Groups: " << stats.groups << " (" << stats.mergedGroups << " merged), Materials: " << stats.materials << " (" << stats.mergedMaterials << " merged)" << std::endl;
+	Log() << "  Vertices: " << stats.vertices << " (" << stats.weldedVertices << " welded), Triangles: " << stats.triangles << ", Bytes Written: " << stats.bytes << std::endl;
+	if(stats.textures > 0) Log() << "  Textures: " << stats.textures << " (" << stats.missingTextures << " missing)" << std::endl;
+
+}
+
+int RunManifest(const std::string &manifestFilePath)
+{
+	std::vector<bom_job_t> jobs;
+	if(!ReadManifest(manifestFilePath, jobs))
+	{
+		if(logErrors) Log() << "ERROR: Failed to open manifest file '" << manifestFilePath << "'" << std::endl;
+		return 1;
+
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	bom_stats_t totalStats;
+	std::mutex statsMutex;
+
+	{
+		WorkerPool pool(std::min<std::size_t>(workerCount, std::max<std::size_t>(1, jobs.size())));
+
+		for(const auto &job : jobs)
+		{
+			pool.Submit([&job, &totalStats, &statsMutex]
+			{
+				bufferLog = true;
+
+				bom_stats_t stats;
+				ConvertBOM(job.bomFilePath, job.objFilePaths, stats);
+				FlushLog();
+
+				std::lock_guard<std::mutex> lock(statsMutex);
+				totalStats += stats;
+
+			});
+
+		}
+
+		pool.Wait();
+
+	}
+
+	PrintStats(totalStats, std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	return totalStats.failedJobs > 0 ? 1 : 0;
+
+}
+
+// Daemon Mode
+// Listens on a Unix domain socket and converts the jobs sent by each client, one job per line in manifest syntax, keeping the worker pool,
+// compiled parsers and material library and texture hash caches warm between jobs.  The log of each job is streamed back as it is written,
+// followed by a status line of 'OK "<output.bom>" <bytes> <seconds>' or 'FAILED "<output.bom>"'.
+#ifndef _WIN32
+class SocketBuffer : public std::streambuf
+{
+public:
+	explicit SocketBuffer(int clientSocket) : clientSocket(clientSocket)
+	{
+		setg(input, input, input);
+		setp(output, output + sizeof(output));
+
+	}
+
+protected:
+	int_type underflow() override
+	{
+		if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+		ssize_t received;
+		do received = recv(clientSocket, input, sizeof(input), 0);
+		while(received < 0 && errno == EINTR);
+		if(received <= 0) return traits_type::eof();
+
+		setg(input, input, input + received);
+		return traits_type::to_int_type(*gptr());
+
+	}
+
+	int_type overflow(int_type character) override
+	{
+		if(sync() != 0) return traits_type::eof();
+		if(traits_type::eq_int_type(character, traits_type::eof())) return traits_type::not_eof(character);
+
+		*pptr() = traits_type::to_char_type(character);
+		pbump(1);
+		return character;
+
+	}
+
+	int sync() override
+	{
+		for(const char *data = pbase(); data < pptr();)
+		{
+			auto sent = send(clientSocket, data, pptr() - data, 0);
+			if(sent < 0 && errno == EINTR) continue;
+			if(sent <= 0) return -1;
+			data += sent;
+
+		}
+
+		setp(output, output + sizeof(output));
+		return 0;
+
+	}
+
+private:
+	int clientSocket;
+	char input[4096], output[4096];
+
+};
+
+volatile std::sig_atomic_t daemonStopping = 0;
+
+void StopDaemon(int)
+{
+	daemonStopping = 1;
+
+}
 
-		}
-		else if(entryType == "v")
-		{
-			obj_vector3_t position;
-			if(!(iss >> position.x >> position.y >> position.z))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+void ServeClient(int clientSocket)
+{
+	SocketBuffer buffer(clientSocket);
+	std::iostream stream(&buffer);
+	clientLog = &stream;
 
-			}
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		bom_job_t job;
+		if(!ParseJob(line, job)) continue;
 
-			positions.push_back(position);
+		bom_stats_t stats;
+		if(job.objFilePaths.empty())
+		{
+			if(logWarnings) Log() << "WARNING: No OBJ file path(s) provided as input for '" << job.bomFilePath << "', job will be skipped." << std::endl;
+			stream << "FAILED " << std::quoted(job.bomFilePath) << std::endl;
 
 		}
-		else if(entryType == "vn")
+		else if(ConvertBOM(job.bomFilePath, job.objFilePaths, stats))
 		{
-			obj_vector3_t normal;
-			if(!(iss >> normal.x >> normal.y >> normal.z))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
-
-			}
-
-			normals.push_back(normal);
+			stream << "OK " << std::quoted(job.bomFilePath) << " " << stats.bytes << " " << stats.seconds << std::endl;
 
 		}
-		else if(entryType == "vt")
+		else
 		{
-			obj_vector2_t uv;
-			float w;
-			if(!(iss >> uv.x >> uv.y))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+			stream << "FAILED " << std::quoted(job.bomFilePath) << std::endl;
 
-			}
-			else if((iss >> w) && w > 0.0f)
-			{
-				if(logWarnings) std::cout << "WARNING: [" << objFilePath << ":" << lineNo << "] 3D texture coordinates are not supported, W component has been discarded." << std::endl;
+		}
 
-			}
+	}
 
-			uvs.push_back(uv);
+	clientLog = nullptr;
 
-		}
-		else if(entryType == "g" || entryType == "o")
-		{
-			if(!isFirstGroup) group = std::make_shared<obj_group_t>();
-			if(!isFirstObject) object = std::make_shared<obj_object_t>();
+}
+#endif
 
-			indices.clear();
-			index = 0;
+int RunDaemon(const std::string &socketPath)
+{
+#ifdef _WIN32
+	if(logErrors) Log() << "ERROR: Daemon mode requires Unix domain sockets, which are not supported on this platform." << std::endl;
+	return 1;
+#else
+	sockaddr_un address {};
+	address.sun_family = AF_UNIX;
+	if(socketPath.size() >= sizeof(address.sun_path))
+	{
+		if(logErrors) Log() << "ERROR: Socket path '" << socketPath << "' is too long." << std::endl;
+		return 1;
 
-			if(!(iss >> group->name))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+	}
 
-			}
+	std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
 
-			group->materialName = objState->materialName;
-			group->materialId = objState->materialId;
-			group->smoothing = objState->smoothing;
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(socketPath.c_str());
+	if(listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0)
+	{
+		if(logErrors) Log() << "ERROR: Failed to listen on socket '" << socketPath << "': " << std::strerror(errno) << std::endl;
+		if(listener >= 0) close(listener);
+		return 1;
 
-			object->groups.push_back(group);
-			isFirstGroup = false;
-			
-			objState->objects.push_back(object);
-			isFirstObject = false;
+	}
 
-		}
-		else if(entryType == "usemtl")
-		{
-			if(!(iss >> objState->materialName))
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+	// Interrupting accept() without restarting it lets SIGINT and SIGTERM stop the daemon, while writes to disconnected clients fail
+	// instead of raising SIGPIPE.
+	struct sigaction stopAction {};
+	stopAction.sa_handler = StopDaemon;
+	sigaction(SIGINT, &stopAction, nullptr);
+	sigaction(SIGTERM, &stopAction, nullptr);
+	std::signal(SIGPIPE, SIG_IGN);
 
-			}
+	Log() << "Listening on '" << socketPath << "' with " << workerCount << " worker(s)..." << std::endl;
 
-			bool foundMaterial = false;
+	std::set<int> clientSockets;
+	std::mutex clientSocketsMutex;
 
-			for(const auto &material : objState->mtlState->materials)
+	{
+		WorkerPool pool(workerCount);
+
+		while(!daemonStopping)
+		{
+			int clientSocket = accept(listener, nullptr, nullptr);
+			if(clientSocket < 0)
 			{
-				if(material.second->name == objState->materialName)
-				{
-					objState->materialId = material.second->id;
-					foundMaterial = true;
-					break;
+				if(errno == EINTR || errno == ECONNABORTED) continue;
 
-				}
+				if(logErrors) Log() << "ERROR: Failed to accept connection on socket '" << socketPath << "': " << std::strerror(errno) << std::endl;
+				break;
 
 			}
 
-			if(!foundMaterial)
 			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Could not find material '" << objState->materialName << "'" << std::endl;
-				return false;
+				std::lock_guard<std::mutex> lock(clientSocketsMutex);
+				clientSockets.insert(clientSocket);
 
 			}
 
-			group->materialName = objState->materialName;
-			group->materialId = objState->materialId;
-
-		}
-		else if(entryType == "s")
-		{
-			std::string smoothing;
-			if(!(iss >> smoothing))
+			pool.Submit([clientSocket, &clientSockets, &clientSocketsMutex]
 			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
-
-			}
+				ServeClient(clientSocket);
 
-			if(smoothing == "off") objState->smoothing = 0;
-			else if(smoothing == "on") objState->smoothing = 1;
-			else objState->smoothing = std::stoi(smoothing);
+				std::lock_guard<std::mutex> lock(clientSocketsMutex);
+				clientSockets.erase(clientSocket);
+				close(clientSocket);
 
-			group->smoothing = objState->smoothing;
+			});
 
 		}
-		else if(entryType == "f")
-		{
-			struct obj_index_t
-			{
-				int a = 0, b = 0, c = 0, d = 0;
-
-			} position, uv, normal;
-			std::smatch matches;
-			
-			// Non-Indexed Geometry
-			auto makeNonIndexedVertices = [&](const auto &positionIndex, const auto &normalIndex, const auto &uvIndex)
-			{
-				if(!positions.empty()) object->positions.push_back(positions[positionIndex >= 0 ? (positionIndex - 1) : (positions.size() + positionIndex)]);
-				if(!normals.empty()) object->normals.push_back(normals[normalIndex >= 0 ? (normalIndex - 1) : (normals.size() + normalIndex)]);
-				if(!uvs.empty()) object->uvs.push_back(uvs[uvIndex >= 0 ? (uvIndex - 1) : (uvs.size() + uvIndex)]);
-				if(!uvs2.empty()) object->uvs2.push_back(uvs2[uvIndex >= 0 ? (uvIndex - 1) : (uvs2.size() + uvIndex)]);
 
-			};
-			
-			// Indexed Geometry
-			auto makeFaceIndex = [&](auto &faceIndex, const auto &positionIndex, const auto &normalIndex, const auto &uvIndex)
-			{
-				auto cacheIndexKey = std::to_string(positionIndex) + "," + std::to_string(normalIndex) + "," + std::to_string(uvIndex);
-				auto cachedIndex = indices.find(cacheIndexKey);
-				if(cachedIndex == indices.end())
-				{
-					indices.insert(std::make_pair(cacheIndexKey, index));
-					faceIndex = index++;
+		// Connected clients are shut down so that they finish their current job and the pool can drain.
+		{
+			std::lock_guard<std::mutex> lock(clientSocketsMutex);
+			for(auto clientSocket : clientSockets) shutdown(clientSocket, SHUT_RDWR);
 
-					if(!positions.empty()) object->positions.push_back(positions[positionIndex >= 0 ? (positionIndex - 1) : (positions.size() + positionIndex)]);
-					if(!normals.empty()) object->normals.push_back(normals[normalIndex >= 0 ? (normalIndex - 1) : (normals.size() + normalIndex)]);
-					if(!uvs.empty()) object->uvs.push_back(uvs[uvIndex >= 0 ? (uvIndex - 1) : (uvs.size() + uvIndex)]);
-					if(!uvs2.empty()) object->uvs2.push_back(uvs2[uvIndex >= 0 ? (uvIndex - 1) : (uvs2.size() + uvIndex)]);
+		}
 
-				}
-				else
-				{
-					faceIndex = cachedIndex->second;
+		pool.Wait();
 
-				}
+	}
 
-			};
-			
-			int numFaces = 0;
+	close(listener);
+	unlink(socketPath.c_str());
 
-			if(std::regex_search(line, matches, FACE_POSITION_UV_NORMAL) && matches.size() >= 10)
-			{
-				numFaces = 3;
+	Log() << "Stopped listening on '" << socketPath << "'." << std::endl;
+	return 0;
+#endif
 
-				position = { std::stoi(matches.str(1)), std::stoi(matches.str(4)), std::stoi(matches.str(7)) };
-				uv = { std::stoi(matches.str(2)), std::stoi(matches.str(5)), std::stoi(matches.str(8)) };
-				normal = { std::stoi(matches.str(3)), std::stoi(matches.str(6)), std::stoi(matches.str(9)) };
-				
-				if(matches.size() >= 13 && !matches.str(10).empty() && !matches.str(11).empty() && !matches.str(12).empty())
-				{
-					position.d = std::stoi(matches.str(10));
-					uv.d = std::stoi(matches.str(11));
-					normal.d = std::stoi(matches.str(12));
-					++numFaces;
+}
 
-				}
+int main(int argc, char *argv[])
+{
+	std::string bomFilePath, manifestFilePath, socketPath;
+	std::vector<std::string> objFilePaths;
+	bool formatVersionGiven = false;
 
-				if(matches.size() >= 16 && !matches.str(13).empty() && !matches.str(14).empty() && !matches.str(15).empty()) ++numFaces;
+	for(int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
 
-			}
-			else if(std::regex_search(line, matches, FACE_POSITION_UV) && matches.size() >= 7)
-			{
-				numFaces = 3;
+		if(arg == "--verify")
+		{
+			verifyOutput = true;
 
-				position = { std::stoi(matches.str(1)), std::stoi(matches.str(3)), std::stoi(matches.str(5)) };
-				uv = { std::stoi(matches.str(2)), std::stoi(matches.str(4)), std::stoi(matches.str(6)) };
-				
-				if(matches.size() >= 9 && !matches.str(7).empty() && !matches.str(8).empty())
-				{
-					position.d = std::stoi(matches.str(7));
-					uv.d = std::stoi(matches.str(8));
-					++numFaces;
+		}
+		else if(arg == "--benchmark" && (i + 1) < argc)
+		{
+			verifyOutput = true;
+			benchmarkIterations = std::max(1, std::atoi(argv[++i]));
 
-				}
+		}
+		else if(arg == "--merge-materials")
+		{
+			mergeMaterials = true;
 
-				if(matches.size() >= 11 && !matches.str(9).empty() && !matches.str(10).empty()) ++numFaces;
+		}
+		else if(arg == "--merge-groups")
+		{
+			mergeGroups = true;
 
-			}
-			else if(std::regex_search(line, matches, FACE_POSITION_NORMAL) && matches.size() >= 7)
-			{
-				numFaces = 3;
+		}
+		else if(arg == "--merge-objects" && (i + 1) < argc)
+		{
+			mergeObjectVertices = std::max(0, std::atoi(argv[++i]));
 
-				position = { std::stoi(matches.str(1)), std::stoi(matches.str(3)), std::stoi(matches.str(5)) };
-				normal = { std::stoi(matches.str(2)), std::stoi(matches.str(4)), std::stoi(matches.str(6)) };
-				
-				if(matches.size() >= 9 &&!matches.str(7).empty() && !matches.str(8).empty())
-				{
-					position.d = std::stoi(matches.str(7));
-					normal.d = std::stoi(matches.str(8));
-					++numFaces;
+		}
+		else if(arg == "--incremental")
+		{
+			incrementalConversion = true;
 
-				}
+		}
+		else if(arg == "--string-table")
+		{
+			writeStringTable = true;
 
-				if(matches.size() >= 11 && !matches.str(9).empty() && !matches.str(10).empty()) ++numFaces;
+		}
+		else if(arg == "--format-version" && (i + 1) < argc)
+		{
+			auto version = std::atoi(argv[++i]);
+			if(version == BOM_DATA_VERSION || version == BOM_LEGACY_DATA_VERSION)
+			{
+				formatVersion = static_cast<std::uint8_t>(version);
+				formatVersionGiven = true;
 
 			}
-			else if(std::regex_search(line, matches, FACE_POSITION) && matches.size() >= 4)
-			{
-				numFaces = 3;
+			else if(logWarnings) Log() << "WARNING: Unsupported BOM format version '" << argv[i] << "', expected " << static_cast<int>(BOM_LEGACY_DATA_VERSION) << " or " << static_cast<int>(BOM_DATA_VERSION) << "." << std::endl;
 
-				position = { std::stoi(matches.str(1)), std::stoi(matches.str(2)), std::stoi(matches.str(3)) };
-				
-				if(matches.size() >= 5 && !matches.str(4).empty())
-				{
-					position.d = std::stoi(matches.str(4));
-					++numFaces;
+		}
+		else if(arg == "--deterministic")
+		{
+			deterministicOutput = true;
 
-				}
+		}
+		else if(arg == "--content-hash")
+		{
+			writeContentHash = true;
 
-				if(matches.size() >= 6 && !matches.str(5).empty()) ++numFaces;
+		}
+		else if(arg == "--check-textures")
+		{
+			checkTextures = true;
 
-			}
-			
-			if(numFaces == 3)
-			{
-				// Triangles
-				if(createIndexedGeometry)
-				{
-					// Indexed Geometry
-					obj_face3_t face;
-					makeFaceIndex(face.a, position.a, normal.a, uv.a);
-					makeFaceIndex(face.b, position.b, normal.b, uv.b);
-					makeFaceIndex(face.c, position.c, normal.c, uv.c);
-					group->faces.push_back(face);
+		}
+		else if(arg == "--dependencies")
+		{
+			writeDependencies = true;
 
-				}
-				else
-				{
-					// Non-Indexed Geometry
-					makeNonIndexedVertices(position.a, normal.a, uv.a);
-					makeNonIndexedVertices(position.b, normal.b, uv.b);
-					makeNonIndexedVertices(position.c, normal.c, uv.c);
+		}
+		else if(arg == "--flip-v")
+		{
+			flipV = true;
 
-				}
+		}
+		else if(arg == "--z-up")
+		{
+			zUpToYUp = true;
 
-			}
-			else if(numFaces == 4)
-			{
-				// Quads
-				if(logWarnings) std::cout << "WARNING: [" << objFilePath << ":" << lineNo << "] Quad geometry faces are automatically triangulated." << std::endl;
+		}
+		else if(arg == "--scale" && (i + 1) < argc)
+		{
+			auto factor = static_cast<float>(std::atof(argv[++i]));
+			if(factor > 0.0f) unitScale = factor;
+			else if(logWarnings) Log() << "WARNING: Ignoring non-positive scale '" << argv[i] << "'." << std::endl;
 
-				// Triangulate Quad Face
-				if(createIndexedGeometry)
-				{
-					// Indexed Geometry
-					obj_face3_t face;
-					makeFaceIndex(face.a, position.a, normal.a, uv.a);
-					makeFaceIndex(face.b, position.b, normal.b, uv.b);
-					makeFaceIndex(face.c, position.c, normal.c, uv.c);
-					group->faces.push_back(face);
-
-					makeFaceIndex(face.a, position.a, normal.a, uv.a);
-					makeFaceIndex(face.b, position.c, normal.c, uv.c);
-					makeFaceIndex(face.c, position.d, normal.d, uv.d);
-					group->faces.push_back(face);
+		}
+		else if(arg == "--no-normals")
+		{
+			readNormals = false;
 
-				}
-				else
-				{
-					// Non-Indexed Geometry
-					makeNonIndexedVertices(position.a, normal.a, uv.a);
-					makeNonIndexedVertices(position.b, normal.b, uv.b);
-					makeNonIndexedVertices(position.c, normal.c, uv.c);
+		}
+		else if(arg == "--no-uv")
+		{
+			readUVs = false;
 
-					makeNonIndexedVertices(position.a, normal.a, uv.a);
-					makeNonIndexedVertices(position.c, normal.c, uv.c);
-					makeNonIndexedVertices(position.d, normal.d, uv.d);
+		}
+		else if(arg == "--no-uv2")
+		{
+			readUV2s = false;
 
-				}
+		}
+		else if(arg == "--normalize-normals")
+		{
+			normalizeNormals = true;
 
-			}
-			else if(numFaces > 4)
-			{
-				// N-gons
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] N-gon geometry faces are not supported." << std::endl;
-				return false;
+		}
+		else if(arg == "--weld" && (i + 1) < argc)
+		{
+			weldTolerance = std::max(0.0f, static_cast<float>(std::atof(argv[++i])));
 
-			}
-			else
-			{
-				if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-				return false;
+		}
+		else if(arg == "--generate-normals")
+		{
+			generateNormals = true;
 
-			}
+		}
+		else if(arg == "--normal-weighting" && (i + 1) < argc)
+		{
+			std::string weighting = argv[++i];
+			if(weighting == "angle") angleWeightedNormals = true;
+			else if(weighting == "area") angleWeightedNormals = false;
+			else if(logWarnings) Log() << "WARNING: Unsupported normal weighting '" << weighting << "', expected 'area' or 'angle'." << std::endl;
 
 		}
-		else if(entryType == "#")
+		else if(arg == "--crease-angle" && (i + 1) < argc)
 		{
-			// Attempt to parse out vendor-specific geometry property
-			// # :<vendor>: <property> [value0] [value1] [valueN...]
-			if((iss >> entryType) && entryType == ":BOM:")
-			{
-				if(!(iss >> entryType))
-				{
-					if(logWarnings) std::cout << "WARNING: [" << objFilePath << ":" << lineNo << "] Vendor-specific geometry entry type could not be parsed and will be skipped." << std::endl;
-					continue;
+			creaseAngle = std::max(0.0f, std::min(180.0f, static_cast<float>(std::atof(argv[++i]))));
 
-				}
+		}
+		else if(arg == "--generate-tangents")
+		{
+			generateTangents = true;
 
-				if(entryType == "vt2")
-				{
-					// UV Channel 2 (vt2)
-					// :BOM: vt2 <u> <v> [w]
-					obj_vector2_t uv2;
-					float w;
-					if(!(iss >> uv2.x >> uv2.y))
-					{
-						if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Syntax error while parsing entry type '" << entryType << "'" << std::endl;
-						return false;
+		}
+		else if(arg == "--bounds")
+		{
+			computeBounds = true;
 
-					}
-					else if((iss >> w) && w > 0.0f)
-					{
-						if(logWarnings) std::cout << "WARNING: [" << objFilePath << ":" << lineNo << "] 3D texture coordinates are not supported, W component has been discarded." << std::endl;
+		}
+		else if(arg == "--bvh")
+		{
+			buildBVH = true;
 
-					}
+		}
+		else if(arg == "--bvh-triangles" && (i + 1) < argc)
+		{
+			buildBVH = true;
+			bvhTriangleThreshold = std::max(1, std::atoi(argv[++i]));
 
-					uvs2.push_back(uv2);
+		}
+		else if(arg == "--manifest" && (i + 1) < argc)
+		{
+			manifestFilePath = argv[++i];
 
-				}
+		}
+		else if(arg == "--daemon" && (i + 1) < argc)
+		{
+			socketPath = argv[++i];
 
-			}
+		}
+		else if(arg == "--jobs" && (i + 1) < argc)
+		{
+			workerCount = std::max(1, std::atoi(argv[++i]));
 
 		}
-		else if(entryType == "p" || entryType == "l" || entryType == "curv" || entryType == "curv2" || entryType == "surf")
+		else if(arg.size() > 2 && arg.compare(0, 2, "--") == 0)
 		{
-			if(logErrors) std::cout << "ERROR: [" << objFilePath << ":" << lineNo << "] Geometry type '" << entryType << "' is not supported." << std::endl;
-			return false;
+			if(logWarnings) Log() << "WARNING: Skipping unsupported option '" << arg << "'" << std::endl;
+
+		}
+		else if(bomFilePath.empty())
+		{
+			bomFilePath = arg;
 
 		}
 		else
 		{
-			if(logWarnings) std::cout << "WARNING: [" << objFilePath << ":" << lineNo << "] Skipping unsupported entry type '" << entryType << "'" << std::endl;
+			objFilePaths.push_back(arg);
 
 		}
 
 	}
 
-	if(isFirstGroup) object->groups.push_back(group);
-	if(isFirstObject) objState->objects.push_back(object);
+	if(incrementalConversion && mergeObjectVertices > 0)
+	{
+		if(logWarnings) Log() << "WARNING: Incremental conversion does not support --merge-objects, as merged objects span several sections, and has been disabled." << std::endl;
+		incrementalConversion = false;
 
-	objFile.close();
+	}
 
-	asset->objStates.push_back(objState);
-	return true;
+	// Bounds, tangents, the string table and the BVH are fields that version 1 readers cannot skip, so they imply version 2 unless version 1
+	// was requested, in which case they are disabled.
+	const std::pair<const char*, bool*> versionTwoOptions[] = { { "--bounds", &computeBounds }, { "--generate-tangents", &generateTangents }, { "--string-table", &writeStringTable }, { "--bvh", &buildBVH } };
+	for(const auto &option : versionTwoOptions)
+	{
+		if(!*option.second || formatVersion == BOM_DATA_VERSION) continue;
 
-}
+		if(formatVersionGiven)
+		{
+			if(logWarnings) Log() << "WARNING: " << option.first << " is not supported by BOM version " << static_cast<int>(formatVersion) << " and has been disabled." << std::endl;
+			*option.second = false;
 
-int main(int argc, char *argv[])
-{
-	std::string bomFilePath;
-	std::vector<std::string> objFilePaths;
+		}
+		else
+		{
+			if(logWarnings) Log() << "WARNING: " << option.first << " requires BOM version " << static_cast<int>(BOM_DATA_VERSION) << ", which will be written." << std::endl;
+			formatVersion = BOM_DATA_VERSION;
 
-	if(argc >= 2) bomFilePath = argv[1];
-	if(bomFilePath.empty())
-	{
-		if(logWarnings) std::cout << "WARNING: No BOM file path provided as output. Syntax: obj2bom <output.bom> <input1.obj> [<input2.obj> ... <inputN.obj>]" << std::endl;
-		return 0;
+		}
 
 	}
 
-	if(argc >= 3) for(int i = 0; i < (argc - 2); ++i) objFilePaths.push_back(argv[2 + i]);
-	if(objFilePaths.empty())
+	if(!socketPath.empty()) return RunDaemon(socketPath);
+	if(!manifestFilePath.empty()) return RunManifest(manifestFilePath);
+
+	if(bomFilePath.empty())
 	{
-		if(logWarnings) std::cout << "WARNING: No OBJ file path(s) provided as input. Syntax: obj2bom <output.bom> <input1.obj> [<input2.obj> ... <inputN.obj>]" << std::endl;
+		if(logWarnings) Log() << "WARNING: No BOM file path provided as output. Syntax: obj2bom [options] <output.bom> <input1.obj> [<input2.obj> ... <inputN.obj>]" << std::endl;
 		return 0;
 
 	}
 
-	std::vector<std::shared_ptr<bom_asset_t>> assets;
-
-	for(const auto &objFilePath : objFilePaths)
+	if(objFilePaths.empty())
 	{
-		// Construct Asset For Each OBJ File
-		// TODO:: Add Command Line Options To Allow Asset Construction Consisting Of Multiple OBJ Files
-		auto asset = std::make_shared<bom_asset_t>();
-		asset->name = objFilePath.substr(objFilePath.find_last_of("/\\") + 1);
-
-		if(ReadOBJ(asset, objFilePath)) assets.push_back(asset);
+		if(logWarnings) Log() << "WARNING: No OBJ file path(s) provided as input. Syntax: obj2bom [options] <output.bom> <input1.obj> [<input2.obj> ... <inputN.obj>]" << std::endl;
+		return 0;
 
 	}
 
-	WriteBOM(assets, bomFilePath);
-	return 0;
+	bom_stats_t stats;
+	return ConvertBOM(bomFilePath, objFilePaths, stats) ? 0 : 1;
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,355 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/bom_reader.h"
+
+// Round-Trip Tests
+// Converts the OBJ fixtures with obj2bom, which verifies every file it writes against its in-memory scene with --verify, then loads the
+// result with the header-only reader and checks properties of the fixture.  Syntax: roundtrip <obj2bom> <fixtures directory> <output directory>
+
+std::string converterPath, fixturesPath, outputPath;
+
+struct test_case_t
+{
+	std::string name, fixture, options;
+	std::function<std::string(const BomReader&)> check; // Returns a description of the first failed check, or an empty string
+
+};
+
+std::string ReadFile(const std::string &filePath)
+{
+	std::ifstream file(filePath, std::ios::in | std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+}
+
+bool CopyFile(const std::string &sourcePath, const std::string &targetPath, const std::string &appended = "")
+{
+	std::ofstream file(targetPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	file << ReadFile(sourcePath) << appended;
+	return file.good();
+
+}
+
+std::string Quote(const std::string &path) { return "\"" + path + "\""; }
+
+bool Convert(const std::string &options, const std::string &bomFilePath, const std::vector<std::string> &objFilePaths)
+{
+	std::string command = Quote(converterPath) + " " + options + " " + Quote(bomFilePath);
+	for(const auto &objFilePath : objFilePaths) command += " " + Quote(objFilePath);
+	command += " > " + Quote(outputPath + "/roundtrip.log") + " 2>&1";
+	return std::system(command.c_str()) == 0;
+
+}
+
+bool Convert(const std::string &options, const std::string &bomFilePath, const std::string &objFilePath) { return Convert(options, bomFilePath, std::vector<std::string> { objFilePath }); }
+
+// Checks shared by every case: every stream an object has holds one value per vertex.
+std::string CheckObjects(const BomReader &reader)
+{
+	for(const auto &asset : reader.assets)
+	{
+		for(const auto &object : asset.objects)
+		{
+			if(object.vertexCount == 0) continue;
+			if(object.positions.size != std::size_t(object.vertexCount) * 3) return "position count";
+			if(!object.normals.empty() && object.normals.size != object.positions.size) return "normal count";
+			if(!object.uvs.empty() && object.uvs.size != std::size_t(object.vertexCount) * 2) return "UV count";
+
+		}
+
+	}
+
+	return "";
+
+}
+
+std::string ExpectVersion(const BomReader &reader, std::uint8_t version)
+{
+	return reader.version == version ? "" : "format version " + std::to_string(reader.version);
+
+}
+
+// Version 1 readers cannot skip the PBR properties, so only version 2 files store the roughness of the green fixture material.
+std::string ExpectRoughness(const BomReader &reader, bool stored)
+{
+	for(const auto &material : reader.materials)
+	{
+		if(std::string(material.name.data, material.name.size) != "green") continue;
+
+		const bool hasRoughness = (material.attributes & BitmaskFlag(MaterialDataAttribute::ROUGHNESS)) != 0;
+		if(hasRoughness != stored || (stored && material.roughness != 0.5f)) return "roughness of material 'green'";
+		return "";
+
+	}
+
+	return "material 'green'";
+
+}
+
+bool RunCase(const test_case_t &test)
+{
+	const std::string bomFilePath = outputPath + "/" + test.name + ".bom";
+	std::remove(bomFilePath.c_str());
+
+	std::string failure;
+	BomReader reader;
+	if(!Convert("--verify " + test.options, bomFilePath, fixturesPath + "/" + test.fixture)) failure = "conversion failed, see roundtrip.log";
+	else if(!reader.Load(bomFilePath)) failure = reader.GetError();
+	else if((failure = CheckObjects(reader)).empty() && test.check) failure = test.check(reader);
+
+	std::cout << (failure.empty() ? "PASS " : "FAIL ") << test.name << (failure.empty() ? "" : ": " + failure) << std::endl;
+	return failure.empty();
+
+}
+
+// Incremental Conversion
+// A rerun with --incremental, before and after appending an object to the fixture, must write the same file as a full conversion.
+bool RunIncrementalCase(const std::string &fixture)
+{
+	const std::string objFilePath = outputPath + "/incremental.obj", incrementalPath = outputPath + "/incremental.bom", fullPath = outputPath + "/full.bom";
+	const std::string name = "incremental_" + fixture.substr(0, fixture.find('.'));
+	std::remove((incrementalPath + ".sections").c_str());
+
+	std::string failure;
+	for(const std::string &appended : { std::string(), std::string(), std::string("\no appended\nf 1 2 3\n") })
+	{
+		if(!CopyFile(fixturesPath + "/" + fixture, objFilePath, appended) || !CopyFile(fixturesPath + "/fixtures.mtl", outputPath + "/fixtures.mtl")) failure = "failed to copy fixture";
+		else if(!Convert("--incremental", incrementalPath, objFilePath) || !Convert("", fullPath, objFilePath)) failure = "conversion failed, see roundtrip.log";
+		else if(ReadFile(incrementalPath) != ReadFile(fullPath)) failure = "incremental and full conversions differ";
+		if(!failure.empty()) break;
+
+	}
+
+	std::cout << (failure.empty() ? "PASS " : "FAIL ") << name << (failure.empty() ? "" : ": " + failure) << std::endl;
+	return failure.empty();
+
+}
+
+// Format Limits
+// More objects than version 1 can count fail the conversion without touching an existing BOM, while version 2 stores them.
+bool RunOverflowCase()
+{
+	const std::string objFilePath = outputPath + "/overflow.obj", bomFilePath = outputPath + "/overflow.bom";
+
+	std::ofstream objFile(objFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	objFile << "v 0 0 0\nv 1 0 0\nv 1 1 0\n";
+	for(int object = 0; object <= std::numeric_limits<std::uint16_t>::max(); ++object) objFile << "o object" << object << "\n";
+	objFile << "f 1 2 3\n";
+	objFile.close();
+
+	std::ofstream(bomFilePath, std::ios::out | std::ios::binary | std::ios::trunc) << "previous";
+
+	std::string failure;
+	BomReader reader;
+	if(Convert("--format-version 1", bomFilePath, objFilePath)) failure = "version 1 conversion succeeded";
+	else if(ReadFile(bomFilePath) != "previous" || !ReadFile(bomFilePath + ".partial").empty()) failure = "failed conversion changed the output";
+	else if(!Convert("--verify --format-version 2", bomFilePath, objFilePath)) failure = "version 2 conversion failed, see roundtrip.log";
+	else if(!reader.Load(bomFilePath)) failure = reader.GetError();
+	else if(reader.assets.size() != 1 || reader.assets[0].objects.size() != std::size_t(std::numeric_limits<std::uint16_t>::max()) + 1) failure = "object count";
+
+	std::cout << (failure.empty() ? "PASS " : "FAIL ") << "overflow" << (failure.empty() ? "" : ": " + failure) << std::endl;
+	return failure.empty();
+
+}
+
+// Corrupt BVH
+// The reader rejects BVH primitives referencing a group or triangles that do not exist, rather than leaving traversal to index past them.
+bool RunCorruptBVHCase()
+{
+	const std::string bomFilePath = outputPath + "/corrupt_bvh.bom";
+
+	std::string failure;
+	BomReader reader;
+	if(!Convert("--bvh", bomFilePath, fixturesPath + "/mixed_streams.obj")) failure = "conversion failed, see roundtrip.log";
+
+	const auto content = ReadFile(bomFilePath);
+	if(failure.empty() && (!reader.Parse(content.data(), content.size()) || reader.bvhPrimitives.size == 0)) failure = "no BVH primitives";
+
+	// Fields of the first primitive: object index, group index, first triangle and triangle count.
+	for(std::size_t field = 1; field < 4 && failure.empty(); ++field)
+	{
+		auto corrupted = content;
+		const std::uint32_t value = std::numeric_limits<std::uint32_t>::max() - 1;
+		std::memcpy(&corrupted[reader.bvhPrimitives.data - content.data() + field * sizeof(value)], &value, sizeof(value));
+
+		BomReader corruptedReader;
+		if(corruptedReader.Parse(corrupted.data(), corrupted.size())) failure = "accepted corrupt primitive field " + std::to_string(field);
+
+	}
+
+	std::cout << (failure.empty() ? "PASS " : "FAIL ") << "corrupt_bvh" << (failure.empty() ? "" : ": " + failure) << std::endl;
+	return failure.empty();
+
+}
+
+// Deterministic Material Order
+// Libraries of the same file name in different directories, one declaring a material twice, give the same material library whichever order
+// the OBJ files are given in, including which of two identical materials is kept when merging.
+bool RunDeterministicCase(const std::string &options)
+{
+	const std::string name = "deterministic" + std::string(options.empty() ? "" : "_merged"), bomFilePath = outputPath + "/" + name + ".bom";
+	const std::string sceneA = fixturesPath + "/library_a/scene.obj", sceneB = fixturesPath + "/library_b/scene.obj";
+
+	auto materialLibrary = [&](const std::vector<std::string> &objFilePaths, std::string &library)
+	{
+		BomReader reader;
+		if(!Convert("--verify --deterministic " + options, bomFilePath, objFilePaths) || !reader.Load(bomFilePath)) return false;
+
+		std::ostringstream materials;
+		for(const auto &material : reader.materials) materials << std::string(material.name.data, material.name.size) << " " << material.diffuseReflectance.r << material.diffuseReflectance.g << material.diffuseReflectance.b << "\n";
+		library = materials.str();
+		return true;
+
+	};
+
+	std::string failure, forward, reverse;
+	if(!materialLibrary({ sceneA, sceneB }, forward) || !materialLibrary({ sceneB, sceneA }, reverse)) failure = "conversion failed, see roundtrip.log";
+	else if(forward != reverse) failure = "material library depends on input order";
+
+	std::cout << (failure.empty() ? "PASS " : "FAIL ") << name << (failure.empty() ? "" : ": " + failure) << std::endl;
+	return failure.empty();
+
+}
+
+// Load-time Benchmark
+// Reports how long the reader takes to parse the largest BOM file written by the tests.
+void RunBenchmark(const std::vector<test_case_t> &tests)
+{
+	static const int ITERATIONS = 1000;
+
+	std::string largest;
+	for(const auto &test : tests)
+	{
+		auto content = ReadFile(outputPath + "/" + test.name + ".bom");
+		if(content.size() > largest.size()) largest.swap(content);
+
+	}
+
+	BomReader reader;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < ITERATIONS; ++i) reader.Parse(largest.data(), largest.size());
+	const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+
+	std::cout << "Benchmark: " << ITERATIONS << " parses of " << largest.size() << " bytes, mean " << time << " ms." << std::endl;
+
+}
+
+int main(int argc, char *argv[])
+{
+	if(argc < 4)
+	{
+		std::cerr << "Syntax: roundtrip <obj2bom> <fixtures directory> <output directory>" << std::endl;
+		return 1;
+
+	}
+
+	converterPath = argv[1];
+	fixturesPath = argv[2];
+	outputPath = argv[3];
+
+	std::vector<test_case_t> tests =
+	{
+		{ "mixed_streams_v1", "mixed_streams.obj", "--format-version 1", [](const BomReader &reader) { return ExpectVersion(reader, 1) + ExpectRoughness(reader, false); } },
+		{ "mixed_streams_v2", "mixed_streams.obj", "--format-version 2", [](const BomReader &reader) { return ExpectVersion(reader, 2) + ExpectRoughness(reader, true); } },
+		{ "mixed_streams_v1_options", "mixed_streams.obj", "--format-version 1 --bounds --generate-normals --generate-tangents --string-table --bvh", [](const BomReader &reader)
+			{
+				// Options adding fields that version 1 readers cannot skip are disabled rather than written.
+				if(reader.version != 1) return std::string("format version");
+				if(!reader.strings.empty() || reader.bvhPrimitives.size != 0) return std::string("string table or BVH");
+				for(const auto &object : reader.assets[0].objects) if(object.attributes & BitmaskFlag(ObjectDataAttribute::BOUNDS) || !object.tangents.empty()) return std::string("bounds or tangents");
+				return std::string();
+
+			}
+		},
+		{ "mixed_streams_v2_options", "mixed_streams.obj", "--bounds --bvh", [](const BomReader &reader) { return ExpectVersion(reader, 2); } },
+		{ "mixed_streams_generated", "mixed_streams.obj", "--generate-normals --generate-tangents --weld 0.001", nullptr },
+		{ "mixed_streams_transformed", "mixed_streams.obj", "--z-up --scale 2 --string-table", nullptr },
+		{ "mixed_streams_hashed", "mixed_streams.obj", "--content-hash --dependencies --bvh", [](const BomReader &reader)
+			{
+				// The reader checks the hash of every section and of the file, the dependency manifest lists the hash of the whole file first.
+				if(reader.sections.empty() || reader.contentHash == 0) return std::string("content hash trailer");
+
+				const auto content = ReadFile(outputPath + "/mixed_streams_hashed.bom");
+				std::ostringstream entry;
+				entry << content.size() << " " << std::hex << std::setw(16) << std::setfill('0') << HashXXH64(content.data(), content.size());
+
+				std::istringstream dependencies(ReadFile(outputPath + "/mixed_streams_hashed.bom.deps"));
+				std::string line;
+				std::getline(dependencies, line);
+				std::getline(dependencies, line);
+				if(line.compare(0, entry.str().size(), entry.str()) != 0) return std::string("dependency manifest hash");
+				return std::string();
+
+			}
+		},
+		{ "mixed_streams_objects", "mixed_streams.obj", "", [](const BomReader &reader)
+			{
+				if(reader.version != 1) return std::string("default format version");
+				if(reader.assets.size() != 1 || reader.assets[0].objects.size() != 5) return std::string("object count");
+				if(reader.materials.size() != 2) return std::string("material count");
+				return std::string();
+
+			}
+		},
+		{ "empty_objects", "empty_objects.obj", "", [](const BomReader &reader)
+			{
+				if(reader.assets.size() != 1 || reader.assets[0].objects.size() != 5) return std::string("object count");
+				for(std::size_t object : { 0, 2, 4 }) if(reader.assets[0].objects[object].vertexCount != 0) return "vertices in empty object " + std::to_string(object);
+				return std::string();
+
+			}
+		},
+		{ "empty_objects_transformed", "empty_objects.obj", "--z-up --scale 2 --generate-tangents", nullptr },
+		{ "malformed_maps", "malformed_maps.obj", "", [](const BomReader &reader)
+			{
+				// Each malformed map line is reported with its line number, and only ends that entry.
+				const auto log = ReadFile(outputPath + "/roundtrip.log");
+				if(log.find("malformed_maps.mtl:3]") == std::string::npos || log.find("malformed_maps.mtl:6]") == std::string::npos) return std::string("map syntax errors");
+				if(reader.materials.size() != 3) return std::string("material count");
+				return std::string();
+
+			}
+		},
+		{ "huge_coordinates_welded", "huge_coordinates.obj", "--weld 0.0000001", [](const BomReader &reader)
+			{
+				if(reader.assets.size() != 1 || reader.assets[0].objects.size() != 1) return std::string("object count");
+				return reader.assets[0].objects[0].vertexCount == 3 ? std::string() : std::string("welded vertex count");
+
+			}
+		},
+		{ "late_streams", "late_streams.obj", "", [](const BomReader &reader)
+			{
+				if(reader.assets.size() != 1 || reader.assets[0].objects.size() != 2) return std::string("object count");
+				const auto &normals = reader.assets[0].objects[0], &uvs = reader.assets[0].objects[1];
+				if(normals.vertexCount != 6 || normals.normals.size != 18 || normals.normals[2] != 0.0f || normals.normals[17] != 1.0f) return std::string("zeroed normals");
+				if(uvs.vertexCount != 6 || uvs.uvs.size != 12 || uvs.uvs[0] != 0.0f || uvs.uvs[11] != 0.5f) return std::string("zeroed UVs");
+				return std::string();
+
+			}
+		}
+
+	};
+
+	bool success = true;
+	for(const auto &test : tests) success = RunCase(test) && success;
+	for(const std::string fixture : { "mixed_streams.obj", "empty_objects.obj" }) success = RunIncrementalCase(fixture) && success;
+	success = RunOverflowCase() && success;
+	success = RunCorruptBVHCase() && success;
+	for(const std::string options : { "", "--merge-materials" }) success = RunDeterministicCase(options) && success;
+	if(success) RunBenchmark(tests);
+
+	return success ? 0 : 1;
+
+}